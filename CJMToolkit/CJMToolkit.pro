@@ -8,13 +8,39 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Lowest logging level compiled into the application: 0 = trace, 1 = info, 2 = warn, 3 = error.
+# Override it from the qmake command line, e.g. "qmake CJM_LOG_MIN_LEVEL=2".
+isEmpty(CJM_LOG_MIN_LEVEL) {
+    CONFIG(debug, debug|release): CJM_LOG_MIN_LEVEL = 0
+    else: CJM_LOG_MIN_LEVEL = 1
+}
+DEFINES += CJM_LOG_MIN_LEVEL=$$CJM_LOG_MIN_LEVEL
+
+# Rotated log files are compressed with zlib.
+LIBS += -lz
+
 SOURCES += \
     common/data/BaseSettings.cpp \
+    common/data/BinaryLog.cpp \
+    common/data/LogArchive.cpp \
     common/data/LogMsg.cpp \
     common/data/Version.cpp \
+    common/io/ConsoleSink.cpp \
+    common/io/FileSink.cpp \
+    common/io/FileSync.cpp \
+    common/io/JsonSink.cpp \
     common/io/Log.cpp \
+    common/io/LogCategory.cpp \
+    common/io/LogClock.cpp \
+    common/io/LogFilter.cpp \
+    common/io/LogLimiter.cpp \
+    common/io/LogSink.cpp \
+    common/io/LogSite.cpp \
+    common/io/MemorySink.cpp \
     common/qt/ButtonSelector.cpp \
     common/qt/InfoDisplay.cpp \
+    common/qt/LogSiteList.cpp \
+    common/qt/MessageHandler.cpp \
     common/qt/Settings.cpp \
     common/qt/StateButton.cpp \
     main.cpp \
@@ -26,12 +52,30 @@ HEADERS += \
     MainWindow.hpp \
     common/algorithm/utility.hpp \
     common/data/BaseSettings.hpp \
+    common/data/BinaryLog.hpp \
     common/data/CircularQueue.hpp \
+    common/data/ConcurrentQueue.hpp \
+    common/data/LogArchive.hpp \
     common/data/LogMsg.hpp \
+    common/data/LogText.hpp \
     common/data/Version.hpp \
+    common/format/Format.hpp \
+    common/io/ConsoleSink.hpp \
+    common/io/FileSink.hpp \
+    common/io/FileSync.hpp \
+    common/io/JsonSink.hpp \
     common/io/Log.hpp \
+    common/io/LogCategory.hpp \
+    common/io/LogClock.hpp \
+    common/io/LogFilter.hpp \
+    common/io/LogLimiter.hpp \
+    common/io/LogSink.hpp \
+    common/io/LogSite.hpp \
+    common/io/MemorySink.hpp \
     common/qt/ButtonSelector.hpp \
     common/qt/InfoDisplay.hpp \
+    common/qt/LogSiteList.hpp \
+    common/qt/MessageHandler.hpp \
     common/qt/Settings.hpp \
     common/qt/StateButton.hpp \
     common/version_info.hpp \
@@ -39,6 +83,21 @@ HEADERS += \
     panels/DebugPanel.hpp \
     version_info.hpp
 
+linux {
+    SOURCES += \
+        common/io/CrashHandler.cpp \
+        common/io/MmapFileSink.cpp \
+        common/io/ShmRing.cpp \
+        common/io/ShmSink.cpp \
+        common/io/UringFileSink.cpp
+    HEADERS += \
+        common/io/CrashHandler.hpp \
+        common/io/MmapFileSink.hpp \
+        common/io/ShmRing.hpp \
+        common/io/ShmSink.hpp \
+        common/io/UringFileSink.hpp
+}
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -29,6 +29,12 @@
 #include <QFile>
 
 using cjm::io::Log;
+using namespace cjm::data::log_literals;
+
+namespace
+{
+   constexpr cjm::io::LogCategory log_category{ "ui.window" }; /**< Category of the messages of the main window. */
+} // namespace
 
 MainWindow::MainWindow(cjm::data::BaseSettings& settings, QWidget* parent) :
    QMainWindow{ parent }, settings_{ settings }
@@ -45,19 +51,19 @@ bool MainWindow::init()
 
    if (!settings_.valid())
    {
-      logger_->error("Invalid settings.");
+      logger_->error("Invalid settings."_lt);
       return false;
    }
 
    if (!loadSettings_())
    {
-      logger_->error("Failed to load settings");
+      logger_->error("Failed to load settings"_lt);
       return false;
    }
 
    if (!initUI_())
    {
-      logger_->error("Failed to initialise the UI.");
+      logger_->error("Failed to initialise the UI."_lt);
       return false;
    }
 
@@ -72,13 +78,13 @@ bool MainWindow::initPages_(PagePanel& panel)
 
    if (!makeObj(logger_, panel.debugPage))
    {
-      logger_->error("Failed to create the DEBUG page.");
+      logger_->error("Failed to create the DEBUG page."_lt);
       return false;
    }
 
    if (!constructObj(logger_, panel.layout))
    {
-      logger_->error("Failed to create the page layout.");
+      logger_->error("Failed to create the page layout."_lt);
       return false;
    }
 
@@ -99,7 +105,7 @@ bool MainWindow::initPageSelector_(PageSelectorPanel& pageSelectorPanel)
 
    if (!makeObj(logger_, pageSelectorPanel.pageSelector_, std::tuple<>(), std::tie(Panel::buttons)))
    {
-      logger_->error("Failed to create the page selector.");
+      logger_->error("Failed to create the page selector."_lt);
       return false;
    }
 
@@ -113,25 +119,25 @@ bool MainWindow::initUI_()
 
    if (!initWindow_())
    {
-      logger_->error("Failed to initialise the main application window.");
+      logger_->error("Failed to initialise the main application window."_lt);
       return false;
    }
 
    if (!initPageSelector_(mainPanel_.pageSelectorPanel))
    {
-      logger_->error("Failed to initialise the page selector.");
+      logger_->error("Failed to initialise the page selector."_lt);
       return false;
    }
 
    if (!initPages_(mainPanel_.pagePanel))
    {
-      logger_->error("Failed to initialise the application pages.");
+      logger_->error("Failed to initialise the application pages."_lt);
       return false;
    }
 
    if (!constructObj(logger_, mainPanel_.mainLayout))
    {
-      logger_->error("Failed to create the main layout.");
+      logger_->error("Failed to create the main layout."_lt);
       return false;
    }
    mainPanel_.mainLayout->setContentsMargins(Panel::margin, Panel::margin, Panel::margin, Panel::margin);
@@ -148,7 +154,7 @@ bool MainWindow::initUI_()
 
    if (!constructObj(logger_, mainPanel_.mainWidget))
    {
-      logger_->error("Failed to create the main widget.");
+      logger_->error("Failed to create the main widget."_lt);
       return false;
    }
 
@@ -171,13 +177,13 @@ bool MainWindow::loadSettings_()
 {
    if (!loadSizes_())
    {
-      logger_->error("Failed to load window sizes.");
+      logger_->error("Failed to load window sizes."_lt);
       return false;
    }
 
    if (!loadStyleSheets_())
    {
-      logger_->error("Failed to load stylesheets.");
+      logger_->error("Failed to load stylesheets."_lt);
       return false;
    }
 
@@ -200,15 +206,18 @@ bool MainWindow::loadSizes_()
          {
             int minimumWidth{ std::atoi(value.data()) };
             setMinimumWidth(minimumWidth);
-            logger_->info("Minimum window width set.", Log::pack("minimum width", minimumWidth));
+            CJM_LOG_CAT_INFO(
+               logger_, log_category, "Minimum window width set.", Log::pack("minimum width"_lt, minimumWidth));
          }
          else
          {
-            logger_->warn(
+            CJM_LOG_CAT_WARN(
+               logger_,
+               log_category,
                "No minimum width specified for the main window.",
-               Log::pack("previous node", Size::node),
-               Log::pack("current node", Size::minimum),
-               Log::pack("missing node", Size::width));
+               Log::pack("previous node"_lt, Size::node),
+               Log::pack("current node"_lt, Size::minimum),
+               Log::pack("missing node"_lt, Size::width));
          }
 
          value = minimumSizeSettings(Size::height);
@@ -216,28 +225,33 @@ bool MainWindow::loadSizes_()
          {
             int minimumHeight{ std::atoi(value.data()) };
             setMinimumHeight(minimumHeight);
-            logger_->info("Mimimum window height set.", Log::pack("minimum height", minimumHeight));
+            CJM_LOG_CAT_INFO(
+               logger_, log_category, "Mimimum window height set.", Log::pack("minimum height"_lt, minimumHeight));
          }
          else
          {
-            logger_->warn(
+            CJM_LOG_CAT_WARN(
+               logger_,
+               log_category,
                "No minimum height specified for the main window.",
-               Log::pack("previous node", Size::node),
-               Log::pack("current node", Size::minimum),
-               Log::pack("missing node", Size::height));
+               Log::pack("previous node"_lt, Size::node),
+               Log::pack("current node"_lt, Size::minimum),
+               Log::pack("missing node"_lt, Size::height));
          }
       }
       else
       {
-         logger_->warn(
+         CJM_LOG_CAT_WARN(
+            logger_,
+            log_category,
             "No minimum size section specified.",
-            Log::pack("current node", Size::node),
-            Log::pack("missing node", Size::minimum));
+            Log::pack("current node"_lt, Size::node),
+            Log::pack("missing node"_lt, Size::minimum));
       }
    }
    else
    {
-      logger_->warn("No size section specified.", Log::pack("missing node", Size::node));
+      CJM_LOG_CAT_WARN(logger_, log_category, "No size section specified.", Log::pack("missing node"_lt, Size::node));
    }
 
    return true;
@@ -260,17 +274,19 @@ bool MainWindow::loadStyleSheets_()
             QFile stylesheetFile{ fileName.data() };
             stylesheetFile.open(QFile::OpenModeFlag::ReadOnly);
             setStyleSheet(stylesheetFile.readAll());
-            logger_->info("Style-sheet set.", Log::pack("file name", fileName));
+            CJM_LOG_CAT_INFO(logger_, log_category, "Style-sheet set.", Log::pack("file name"_lt, fileName));
          }
          else
          {
-            logger_->warn("Non-existent stylesheet file.", Log::pack("file name", fileName));
+            CJM_LOG_CAT_WARN(
+               logger_, log_category, "Non-existent stylesheet file.", Log::pack("file name"_lt, fileName));
          }
       }
    }
    else
    {
-      logger_->warn("No style-sheet section specified.", Log::pack("missing node", StyleSheet::name));
+      CJM_LOG_CAT_WARN(
+         logger_, log_category, "No style-sheet section specified.", Log::pack("missing node"_lt, StyleSheet::name));
    }
 
    return true;
@@ -31,6 +31,11 @@
 
 namespace cjm::alg
 {
+   /**
+    * @brief Category of the messages about the construction of objects, mostly widgets.
+    */
+   inline constexpr cjm::io::LogCategory construct_category{ "ui.construct" };
+
    /**
     * @brief Construct an object on the heap.
     * @tparam DstType Type of the pointer that will store the memory address of the newly created object.
@@ -45,6 +50,8 @@ namespace cjm::alg
    bool constructObj(
       cjm::io::Log* logger, DstType*& obj, std::tuple<ConstructorArgs&...>&& constructorArgs = std::tuple<>())
    {
+      using namespace cjm::data::log_literals;
+
       // Allocate memory.
       auto create = [](auto... args) { return new TrueType(args...); };
 
@@ -54,15 +61,17 @@ namespace cjm::alg
       if (obj == nullptr)
       {
          logger->error(
-            "Memory allocation failed.",
-            cjm::io::Log::pack("object type", typeid(obj).name()),
-            cjm::io::Log::pack("object size [B]", sizeof(TrueType)));
+            "Memory allocation failed."_lt,
+            cjm::io::Log::pack("object type"_lt, typeid(obj).name()),
+            cjm::io::Log::pack("object size [B]"_lt, sizeof(TrueType)));
          return false;
       }
-      logger->trace(
+      CJM_LOG_CAT_TRACE(
+         logger,
+         construct_category,
          "Memory allocated.",
-         cjm::io::Log::pack("object type", typeid(obj).name()),
-         cjm::io::Log::pack("object size [B]", sizeof(TrueType)));
+         cjm::io::Log::pack("object type"_lt, typeid(obj).name()),
+         cjm::io::Log::pack("object size [B]"_lt, sizeof(TrueType)));
 
       return true;
    }
@@ -79,15 +88,18 @@ namespace cjm::alg
    template<typename DstType, typename... InitArgs>
    bool initObj(cjm::io::Log* logger, DstType* obj, std::tuple<InitArgs&...>&& initArgs = std::tuple<>())
    {
+      using namespace cjm::data::log_literals;
+
       // Initialise the object.
       auto initialise = [obj](auto... args) { return obj->init(args...); };
 
       if (!std::apply(initialise, std::forward<std::tuple<InitArgs&...>>(initArgs)))
       {
-         logger->error("Initialisation failed.", cjm::io::Log::pack("object type", typeid(obj).name()));
+         logger->error("Initialisation failed."_lt, cjm::io::Log::pack("object type"_lt, typeid(obj).name()));
          return false;
       }
-      logger->trace("Object initialised.", cjm::io::Log::pack("object type", typeid(obj).name()));
+      CJM_LOG_CAT_TRACE(
+         logger, construct_category, "Object initialised.", cjm::io::Log::pack("object type"_lt, typeid(obj).name()));
 
       return true;
    }
@@ -111,22 +123,28 @@ namespace cjm::alg
       std::tuple<ConstructorArgs&...>&& constructorArgs = std::tuple<>(),
       std::tuple<InitArgs&...>&&        initArgs = std::tuple<>())
    {
+      using namespace cjm::data::log_literals;
+
       if (!constructObj<DstType, TrueType, ConstructorArgs...>(
              logger, obj, std::forward<std::tuple<ConstructorArgs&...>>(constructorArgs)))
       {
-         logger->error("Failed to create object.");
+         logger->error("Failed to create object."_lt);
          return false;
       }
 
       if (!initObj(logger, obj, std::forward<std::tuple<InitArgs&...>>(initArgs)))
       {
-         logger->error("Failed to initialise object.");
+         logger->error("Failed to initialise object."_lt);
          delete obj;
          obj = nullptr;
          return false;
       }
 
-      logger->trace("Object created and initialised.", cjm::io::Log::pack("object type", typeid(obj).name()));
+      CJM_LOG_CAT_TRACE(
+         logger,
+         construct_category,
+         "Object created and initialised.",
+         cjm::io::Log::pack("object type"_lt, typeid(obj).name()));
       return true;
    }
 } // namespace cjm::alg
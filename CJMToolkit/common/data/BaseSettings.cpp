@@ -27,6 +27,12 @@
 namespace cjm::data
 {
    using cjm::io::Log;
+   using namespace cjm::data::log_literals;
+
+   namespace
+   {
+      constexpr cjm::io::LogCategory log_category{ "settings.xml" }; /**< Category of the settings messages. */
+   } // namespace
 
    BaseSettings::BaseSettings()
    {
@@ -38,7 +44,7 @@ namespace cjm::data
       root_ = std::unique_ptr<Node>(new Node());
       if (root_ == nullptr)
       {
-         logger_->error("Failed to allocate the root of the settings tree.");
+         logger_->error("Failed to allocate the root of the settings tree."_lt);
       }
 
       currentNode_ = root_.get();
@@ -59,7 +65,12 @@ namespace cjm::data
       }
       else
       {
-         logger_->warn("Node not found.", Log::pack("node name", nodeName), Log::pack("index", index));
+         CJM_LOG_CAT_WARN(
+            logger_,
+            log_category,
+            "Node not found.",
+            Log::pack("node name"_lt, nodeName),
+            Log::pack("index"_lt, index));
          return default_value;
       }
    }
@@ -89,10 +100,12 @@ namespace cjm::data
       }
       else
       {
-         logger_->warn(
+         CJM_LOG_CAT_WARN(
+            logger_,
+            log_category,
             "Trying to add a node to a non-existent node.",
-            Log::pack("node name", nodeName),
-            Log::pack("value", value));
+            Log::pack("node name"_lt, nodeName),
+            Log::pack("value"_lt, value));
       }
    }
 
@@ -112,8 +125,10 @@ namespace cjm::data
       }
       else
       {
-         logger_->warn(
-            "Trying to retrieve an attribute from a non-existent node.", Log::pack("attribute name", attributeName));
+         CJM_LOG_CAT_WARN(
+            logger_,
+            log_category,
+            "Trying to retrieve an attribute from a non-existent node.", Log::pack("attribute name"_lt, attributeName));
          return default_value;
       }
    }
@@ -127,7 +142,7 @@ namespace cjm::data
 
          if (index < 0 && index != last_node_idx)
          {
-            logger_->warn("Passed invalid index to enterNode.", Log::pack("index", index));
+            CJM_LOG_CAT_WARN(logger_, log_category, "Passed invalid index to enterNode.", Log::pack("index"_lt, index));
             return BaseSettings(nullptr);
          }
 
@@ -146,10 +161,12 @@ namespace cjm::data
       }
       else
       {
-         logger_->warn(
+         CJM_LOG_CAT_WARN(
+            logger_,
+            log_category,
             "Trying to enter a child of a non-existent node.",
-            Log::pack("node name", nodeName),
-            Log::pack("index", index));
+            Log::pack("node name"_lt, nodeName),
+            Log::pack("index"_lt, index));
          return BaseSettings(nullptr);
       }
    }
@@ -170,10 +187,12 @@ namespace cjm::data
       }
       else
       {
-         logger_->warn(
+         CJM_LOG_CAT_WARN(
+            logger_,
+            log_category,
             "Trying to add an attribute to a non-existent node.",
-            Log::pack("attribute name", attributeName),
-            Log::pack("value", value));
+            Log::pack("attribute name"_lt, attributeName),
+            Log::pack("value"_lt, value));
       }
    }
 
@@ -185,7 +204,8 @@ namespace cjm::data
       }
       else
       {
-         logger_->warn("Trying to set the value of a non-existent node.", Log::pack("value", value));
+         CJM_LOG_CAT_WARN(
+            logger_, log_category, "Trying to set the value of a non-existent node.", Log::pack("value"_lt, value));
       }
    }
 
@@ -202,7 +222,7 @@ namespace cjm::data
       }
       else
       {
-         logger_->warn("Trying to get the value of a non-existent node.");
+         CJM_LOG_CAT_WARN(logger_, log_category, "Trying to get the value of a non-existent node.");
          return default_value;
       }
    }
@@ -214,13 +234,14 @@ namespace cjm::data
          auto nodeVec = currentNode_->children.find(nodeName);
          if (nodeVec == currentNode_->children.end())
          {
-            logger_->error("Node does not exist.", Log::pack("node name", nodeName), Log::pack("index", index));
+            logger_->error(
+               "Node does not exist."_lt, Log::pack("node name"_lt, nodeName), Log::pack("index"_lt, index));
             return;
          }
 
          if (index < 0 && index != last_node_idx)
          {
-            logger_->error("Passed invalid index to enterNode.", Log::pack("index", index));
+            logger_->error("Passed invalid index to enterNode."_lt, Log::pack("index"_lt, index));
             return;
          }
 
@@ -235,9 +256,9 @@ namespace cjm::data
             if (nodeVec->second.size() <= uIndex)
             {
                logger_->error(
-                  "Not enough nodes: index too high.",
-                  Log::pack("index", uIndex),
-                  Log::pack("number of nodes", nodeVec->second.size()));
+                  "Not enough nodes: index too high."_lt,
+                  Log::pack("index"_lt, uIndex),
+                  Log::pack("number of nodes"_lt, nodeVec->second.size()));
                return;
             }
          }
@@ -247,9 +268,9 @@ namespace cjm::data
       else
       {
          logger_->error(
-            "Trying to enter a child of a non-existent node.",
-            Log::pack("node name", nodeName),
-            Log::pack("index", index));
+            "Trying to enter a child of a non-existent node."_lt,
+            Log::pack("node name"_lt, nodeName),
+            Log::pack("index"_lt, index));
          return;
       }
    }
@@ -262,7 +283,7 @@ namespace cjm::data
       }
       else
       {
-         logger_->error("Trying to exit a non-existent node.");
+         logger_->error("Trying to exit a non-existent node."_lt);
       }
    }
 
@@ -274,7 +295,7 @@ namespace cjm::data
       }
       else
       {
-         logger_->error("No root specified.");
+         logger_->error("No root specified."_lt);
       }
    }
 } // namespace cjm::data
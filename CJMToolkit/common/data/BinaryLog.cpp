@@ -0,0 +1,396 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "BinaryLog.hpp"
+
+#include "LogMsg.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace cjm::data
+{
+   namespace
+   {
+      /**
+       * @brief Global table of interned texts.
+       */
+      struct InternTable
+      {
+         std::mutex                                          mtx;     /**< Mutex protecting the table. */
+         std::deque<std::string>                             texts;   /**< Interned texts, indexed by id. */
+         std::unordered_map<std::string_view, std::uint32_t> ids;     /**< Ids of the interned texts. */
+         size_t                                              dynamic; /**< Texts interned by internDynamic. */
+      };
+
+      /**
+       * @brief Entry of the thread-local intern cache.
+       */
+      struct CacheEntry
+      {
+         const char*      data{ nullptr }; /**< Pointer of the cached text. */
+         std::string_view text;            /**< Interned copy of the text. */
+         std::uint32_t    id{ 0U };        /**< Id of the text. */
+      };
+
+      constexpr size_t cache_size{ 256U }; /**< Number of entries in the thread-local intern cache. */
+
+      InternTable& internTable()
+      {
+         static InternTable table{};
+         return table;
+      }
+
+      /**
+       * @brief Intern a text, first looking it up in the thread-local cache.
+       * @param text Text to intern.
+       * @param bounded If true, a new text is only interned while the budget of non-literal texts is not spent.
+       * @param id Id of the text, set on success.
+       * @return true if the text is interned, false otherwise.
+       */
+      bool internText(std::string_view text, bool bounded, std::uint32_t& id)
+      {
+         thread_local std::array<CacheEntry, cache_size> cache;
+
+         // Fast path: the same pointer with the same contents was already interned by this thread.
+         CacheEntry& entry{ cache[(reinterpret_cast<std::uintptr_t>(text.data()) >> 3U) % cache_size] };
+         if (entry.data == text.data() && entry.text == text)
+         {
+            id = entry.id;
+            return true;
+         }
+
+         InternTable&     table{ internTable() };
+         std::scoped_lock lck{ table.mtx };
+
+         auto found = table.ids.find(text);
+         if (found == table.ids.end())
+         {
+            if (bounded)
+            {
+               if (table.dynamic >= BinaryLog::dynamic_texts) return false;
+               ++table.dynamic;
+            }
+            const std::string& newText{ table.texts.emplace_back(text) };
+            found = table.ids.emplace(newText, static_cast<std::uint32_t>(table.texts.size() - 1U)).first;
+         }
+
+         entry = CacheEntry{ text.data(), found->first, found->second };
+         id = found->second;
+         return true;
+      }
+
+      /**
+       * @brief Read a raw value from a payload.
+       * @return true on success, false if the payload is too short.
+       */
+      template<typename Type>
+      bool readValue(std::string_view payload, size_t& offset, Type& value)
+      {
+         if (payload.size() - offset < sizeof(Type)) return false;
+         std::memcpy(&value, payload.data() + offset, sizeof(Type));
+         offset += sizeof(Type);
+         return true;
+      }
+
+      /**
+       * @brief Read a raw value from a stream.
+       * @return true on success, false otherwise.
+       */
+      template<typename Type>
+      bool readValue(std::istream& stream, Type& value)
+      {
+         return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(Type)));
+      }
+
+      /**
+       * @brief Read a text whose length comes from a stream.
+       * @details The text grows with the data actually read, so a damaged length cannot allocate more memory than the
+       *          rest of the stream contains.
+       * @return true on success, false if the stream ends first.
+       */
+      bool readString(std::istream& stream, std::uint32_t length, std::string& text)
+      {
+         constexpr size_t chunk_size{ 64U * 1024U };
+
+         text.clear();
+         while (text.size() < length)
+         {
+            size_t offset{ text.size() };
+            size_t chunk{ std::min<size_t>(length - offset, chunk_size) };
+            text.resize(offset + chunk);
+            if (!stream.read(text.data() + offset, static_cast<std::streamsize>(chunk))) return false;
+         }
+         return true;
+      }
+
+      /**
+       * @brief Output that formats a single value in a fixed buffer, without allocating.
+       */
+      struct ValueOutput
+      {
+         std::array<char, cjm::fmt::number_size> buffer;     /**< Formatted value. */
+         size_t                                  size{ 0U }; /**< Size of the formatted value. */
+
+         /**
+          * @brief Append text to the buffer, truncating it if the buffer is full.
+          * @param data Text to append.
+          * @param length Size of the text.
+          */
+         void append(const char* data, size_t length)
+         {
+            length = std::min(length, buffer.size() - size);
+            std::memcpy(buffer.data() + size, data, length);
+            size += length;
+         }
+      };
+
+      /**
+       * @brief Read a value from a payload and convert it to text.
+       * @param payload Encoded data.
+       * @param offset Position of the value, moved past it.
+       * @param output Buffer that stores the text.
+       * @param text Text of the value, pointing into the buffer.
+       * @return true on success, false if the payload is too short.
+       */
+      template<typename Type>
+      bool readText(std::string_view payload, size_t& offset, ValueOutput& output, std::string_view& text)
+      {
+         Type value{};
+         if (!readValue(payload, offset, value)) return false;
+
+         output.size = 0U;
+         cjm::fmt::format(output, value);
+         text = std::string_view(output.buffer.data(), output.size);
+         return true;
+      }
+
+      /**
+       * @brief Append the raw bytes of a value to a string.
+       */
+      template<typename Type>
+      void writeValue(std::string& output, const Type& value)
+      {
+         output.append(reinterpret_cast<const char*>(&value), sizeof(Type));
+      }
+   } // namespace
+
+   std::vector<std::pair<std::string, std::string>>
+      BinaryLog::decodeData(std::string_view payload, const Lookup& lookup)
+   {
+      std::vector<std::pair<std::string, std::string>> data;
+      visitData(payload, [&data, &lookup](const Field& field) {
+         data.emplace_back(field.descriptionId != no_id ? lookup(field.descriptionId) : field.description, field.value);
+      });
+
+      return data;
+   }
+
+   std::uint32_t BinaryLog::formatCount()
+   {
+      InternTable&     table{ internTable() };
+      std::scoped_lock lck{ table.mtx };
+      return static_cast<std::uint32_t>(table.texts.size());
+   }
+
+   std::uint32_t BinaryLog::intern(std::string_view text)
+   {
+      std::uint32_t id{ no_id };
+      internText(text, false, id);
+      return id;
+   }
+
+   bool BinaryLog::internDynamic(std::string_view text, std::uint32_t& id)
+   {
+      return internText(text, true, id);
+   }
+
+   bool BinaryLog::readRecord(std::istream& stream, Record& record, std::string_view signature)
+   {
+      if (!readValue(stream, record.type)) return false;
+
+      switch (record.type)
+      {
+      case RecordType::format:
+      {
+         std::uint32_t length{ 0U };
+         return readValue(stream, record.id) && readValue(stream, length) && readString(stream, length, record.text);
+      }
+      case RecordType::message:
+      {
+         std::uint32_t length{ 0U };
+         if (!readValue(stream, record.level) || !readValue(stream, record.timestamp) || !readValue(stream, record.id))
+            return false;
+
+         // Texts that were not interned precede the payload.
+         record.text.clear();
+         if (record.id == no_id && signature == magic)
+         {
+            if (!readValue(stream, length) || !readString(stream, length, record.text)) return false;
+         }
+
+         return readValue(stream, length) && readString(stream, length, record.payload);
+      }
+      }
+
+      return false;
+   }
+
+   std::string_view BinaryLog::text(std::uint32_t id)
+   {
+      InternTable&     table{ internTable() };
+      std::scoped_lock lck{ table.mtx };
+      return id < table.texts.size() ? std::string_view(table.texts[id]) : std::string_view();
+   }
+
+   bool BinaryLog::tryText(std::uint32_t id, std::string_view& text)
+   {
+      InternTable& table{ internTable() };
+      if (!table.mtx.try_lock()) return false;
+
+      bool found{ id < table.texts.size() };
+      if (found) text = table.texts[id];
+      table.mtx.unlock();
+      return found;
+   }
+
+   bool BinaryLog::visitData(std::string_view payload, const Visitor& visitor)
+   {
+      size_t offset{ 0U };
+      while (offset < payload.size())
+      {
+         Field field;
+         if (!readValue(payload, offset, field.descriptionId)) return false;
+         if (field.descriptionId == no_id)
+         {
+            std::uint32_t length{ 0U };
+            if (!readValue(payload, offset, length) || payload.size() - offset < length) return false;
+            field.description = payload.substr(offset, length);
+            offset += length;
+         }
+
+         if (!readValue(payload, offset, field.type)) return false;
+
+         ValueOutput      output;
+         std::string_view value;
+         bool             valid{ false };
+         switch (field.type)
+         {
+         case ArgType::boolean:
+            valid = readText<bool>(payload, offset, output, value);
+            break;
+         case ArgType::character:
+            valid = readText<char>(payload, offset, output, value);
+            break;
+         case ArgType::int8:
+            valid = readText<std::int8_t>(payload, offset, output, value);
+            break;
+         case ArgType::int16:
+            valid = readText<std::int16_t>(payload, offset, output, value);
+            break;
+         case ArgType::int32:
+            valid = readText<std::int32_t>(payload, offset, output, value);
+            break;
+         case ArgType::int64:
+            valid = readText<std::int64_t>(payload, offset, output, value);
+            break;
+         case ArgType::uint8:
+            valid = readText<std::uint8_t>(payload, offset, output, value);
+            break;
+         case ArgType::uint16:
+            valid = readText<std::uint16_t>(payload, offset, output, value);
+            break;
+         case ArgType::uint32:
+            valid = readText<std::uint32_t>(payload, offset, output, value);
+            break;
+         case ArgType::uint64:
+            valid = readText<std::uint64_t>(payload, offset, output, value);
+            break;
+         case ArgType::float32:
+            valid = readText<float>(payload, offset, output, value);
+            break;
+         case ArgType::float64:
+            valid = readText<double>(payload, offset, output, value);
+            break;
+         case ArgType::level:
+         {
+            std::uint8_t level{ 0U };
+            valid = readValue(payload, offset, level) && level < LogMsg::level_keys.size();
+            if (valid) value = LogMsg::level_keys[level];
+            break;
+         }
+         case ArgType::string:
+         {
+            std::uint32_t length{ 0U };
+            valid = readValue(payload, offset, length) && payload.size() - offset >= length;
+            if (valid)
+            {
+               value = payload.substr(offset, length);
+               offset += length;
+            }
+            break;
+         }
+         }
+
+         if (!valid) return false;
+         field.value = value;
+         visitor(field);
+      }
+
+      return true;
+   }
+
+   void BinaryLog::writeFormat(std::string& output, std::uint32_t id, std::string_view text)
+   {
+      writeValue(output, RecordType::format);
+      writeValue(output, id);
+      writeValue(output, static_cast<std::uint32_t>(text.size()));
+      output.append(text);
+   }
+
+   void BinaryLog::writeMessage(
+      std::string&     output,
+      std::uint8_t     level,
+      long long        timestamp,
+      std::uint32_t    id,
+      std::string_view text,
+      std::string_view payload)
+   {
+      writeValue(output, RecordType::message);
+      writeValue(output, level);
+      writeValue(output, timestamp);
+      writeValue(output, id);
+      if (id == no_id)
+      {
+         writeValue(output, static_cast<std::uint32_t>(text.size()));
+         output.append(text);
+      }
+      writeValue(output, static_cast<std::uint32_t>(payload.size()));
+      output.append(payload);
+   }
+} // namespace cjm::data
@@ -0,0 +1,393 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_DATA_BINARYLOG_HPP
+#define COMMON_DATA_BINARYLOG_HPP
+
+#include "LogText.hpp"
+#include "common/format/Format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cjm::data
+{
+   /**
+    * @brief Binary encoding of logging messages.
+    * @details Literal messages and data descriptions are interned in a global table and referenced by id, while
+    *          any other text is stored inline with a length prefix, so the table only grows with the literals of the
+    *          program. The data itself is stored as raw bytes. Text is only produced when a record is decoded. All
+    *          values are stored with the byte order of the host.
+    *          Encoded data is written to an Output object, which only needs an append(const char*, size_t) method,
+    *          like std::string.
+    */
+   class BinaryLog
+   {
+   public:
+      using Lookup = std::function<std::string_view(std::uint32_t)>; /**< Function that maps ids to text. */
+
+      /**
+       * @brief Types of records in a binary log file.
+       */
+      enum class RecordType : std::uint8_t
+      {
+         format = 1, /**< Definition of an interned text. */
+         message = 2 /**< Logging message. */
+      };
+
+      /**
+       * @brief Types of the encoded data.
+       */
+      enum class ArgType : std::uint8_t
+      {
+         boolean,
+         character,
+         int8,
+         int16,
+         int32,
+         int64,
+         uint8,
+         uint16,
+         uint32,
+         uint64,
+         float32,
+         float64,
+         level,
+         string
+      };
+
+      /**
+       * @brief Decoded datagram.
+       */
+      struct Field
+      {
+         std::uint32_t    descriptionId{ no_id };  /**< Id of the interned description, or no_id if it is inline. */
+         std::string_view description;             /**< Description stored inline, empty if it is interned. */
+         ArgType          type{ ArgType::string }; /**< Type of the value when it was encoded. */
+         std::string_view value;                   /**< Value in text form. */
+      };
+
+      using Visitor = std::function<void(const Field&)>; /**< Function that receives each decoded datagram. */
+
+      /**
+       * @brief Decoded record of a binary log file.
+       */
+      struct Record
+      {
+         RecordType    type{ RecordType::message }; /**< Type of the record. */
+         std::uint8_t  level{ 0U };                 /**< Level of a message. */
+         long long     timestamp{ 0 };              /**< Timestamp of a message [ns]. */
+         std::uint32_t id{ 0U };                    /**< Id of the defined text or of the message text. */
+         std::string   text;                        /**< Text of a format definition, or of a message without id. */
+         std::string   payload;                     /**< Encoded data of a message. */
+      };
+
+      static constexpr std::string_view magic{ "CJMBLOG3" };          /**< Signature at the start of a binary log. */
+      static constexpr std::string_view interned_magic{ "CJMBLOG2" }; /**< Signature of logs without inline text. */
+      static constexpr std::string_view legacy_magic{ "CJMBLOG1" };   /**< Signature of logs with timestamps in [ms]. */
+      static constexpr std::uint32_t    no_id{ UINT32_MAX };           /**< Id of a text that is not interned. */
+      static constexpr size_t           dynamic_texts{ 1024U };        /**< Most non-literal texts to intern. */
+
+      /**
+       * @brief Get the tag under which a value is encoded.
+       * @tparam DataType Type of the value.
+       * @return Tag of booleans, characters, integers, enumerations and floating point numbers. Everything else is
+       *         stored as text and gets ArgType::string.
+       */
+      template<typename DataType>
+      static constexpr ArgType argType()
+      {
+         using Type = std::decay_t<DataType>;
+
+         if constexpr (std::is_same_v<Type, bool>)
+         {
+            return ArgType::boolean;
+         }
+         else if constexpr (std::is_same_v<Type, char>)
+         {
+            return ArgType::character;
+         }
+         else if constexpr (std::is_enum_v<Type>)
+         {
+            return argType<std::underlying_type_t<Type>>();
+         }
+         else if constexpr (std::is_integral_v<Type>)
+         {
+            constexpr size_t index{ sizeof(Type) == 1U ? 0U : sizeof(Type) == 2U ? 1U : sizeof(Type) == 4U ? 2U : 3U };
+            constexpr ArgType signed_tags[]{ ArgType::int8, ArgType::int16, ArgType::int32, ArgType::int64 };
+            constexpr ArgType unsigned_tags[]{ ArgType::uint8, ArgType::uint16, ArgType::uint32, ArgType::uint64 };
+
+            return std::is_signed_v<Type> ? signed_tags[index] : unsigned_tags[index];
+         }
+         else if constexpr (std::is_same_v<Type, float>)
+         {
+            return ArgType::float32;
+         }
+         else if constexpr (std::is_same_v<Type, double>)
+         {
+            return ArgType::float64;
+         }
+         else
+         {
+            return ArgType::string;
+         }
+      }
+
+      /**
+       * @brief Decode the data attached to a message.
+       * @param payload Encoded data.
+       * @param lookup Function used to retrieve the descriptions of the data.
+       * @return Pairs (description, value) in text form.
+       */
+      static std::vector<std::pair<std::string, std::string>>
+         decodeData(std::string_view payload, const Lookup& lookup);
+
+      /**
+       * @brief Encode a datagram.
+       * @tparam Output Type of the destination.
+       * @tparam DataType Type of the data.
+       * @param output Destination of the encoded data.
+       * @param description Description of the data. Interned if it is a literal, otherwise stored inline.
+       * @param data Data to encode. Arithmetic types, enumerations and strings are stored as raw bytes, everything
+       *             else is converted to text.
+       */
+      template<typename Output, typename DataType>
+      static void encodeData(Output& output, LogText description, const DataType& data)
+      {
+         using Type = std::decay_t<DataType>;
+
+         encodeDescription_(output, description);
+
+         if constexpr (std::is_same_v<Type, bool>)
+         {
+            appendTagged_(output, ArgType::boolean, data);
+         }
+         else if constexpr (std::is_same_v<Type, char>)
+         {
+            appendTagged_(output, ArgType::character, data);
+         }
+         else if constexpr (std::is_enum_v<Type>)
+         {
+            encodeInteger_(output, static_cast<std::underlying_type_t<Type>>(data));
+         }
+         else if constexpr (std::is_integral_v<Type>)
+         {
+            encodeInteger_(output, data);
+         }
+         else if constexpr (std::is_same_v<Type, float>)
+         {
+            appendTagged_(output, ArgType::float32, data);
+         }
+         else if constexpr (std::is_same_v<Type, double>)
+         {
+            appendTagged_(output, ArgType::float64, data);
+         }
+         else if constexpr (std::is_convertible_v<const DataType&, std::string_view>)
+         {
+            encodeString(output, data);
+         }
+         else
+         {
+            encodeString(output, cjm::fmt::toString(data));
+         }
+      }
+
+      /**
+       * @brief Encode a logging level.
+       * @tparam Output Type of the destination.
+       * @param output Destination of the encoded data.
+       * @param description Description of the level. Interned if it is a literal, otherwise stored inline.
+       * @param level Numeric value of the level.
+       */
+      template<typename Output>
+      static void encodeLevel(Output& output, LogText description, std::uint8_t level)
+      {
+         encodeDescription_(output, description);
+         appendTagged_(output, ArgType::level, level);
+      }
+
+      /**
+       * @brief Encode the value of a string datagram. The description must already be encoded.
+       * @tparam Output Type of the destination.
+       * @param output Destination of the encoded data.
+       * @param data String to encode.
+       */
+      template<typename Output>
+      static void encodeString(Output& output, std::string_view data)
+      {
+         appendTagged_(output, ArgType::string, static_cast<std::uint32_t>(data.size()));
+         output.append(data.data(), data.size());
+      }
+
+      /**
+       * @brief Get the number of interned texts.
+       * @return Number of interned texts. Ids are always lower than this value.
+       */
+      static std::uint32_t formatCount();
+
+      /**
+       * @brief Intern a text and get its id.
+       * @details The same text always gets the same id. Repeated calls with the same pointer are served by a
+       *          thread-local cache without locking. Interned texts are never released, so only texts from a bounded
+       *          set, like string literals, should be interned. Other texts go through internDynamic.
+       * @param text Text to intern.
+       * @return Id of the text.
+       */
+      static std::uint32_t intern(std::string_view text);
+
+      /**
+       * @brief Intern a text that is not known to be a literal, as long as few such texts were interned.
+       * @details Texts that are already interned always get their id. A new text is only interned while fewer than
+       *          dynamic_texts texts were interned this way, so that texts built at runtime cannot grow the table
+       *          without bounds.
+       * @param text Text to intern.
+       * @param id Id of the text, set on success.
+       * @return true if the text is interned, false otherwise.
+       */
+      static bool internDynamic(std::string_view text, std::uint32_t& id);
+
+      /**
+       * @brief Read the next record from a binary log file.
+       * @param stream Input stream, positioned after the signature.
+       * @param record Destination of the decoded record.
+       * @param signature Signature of the file. Only the current version stores the texts that are not interned.
+       * @return true on success, false at the end of the file or on a malformed record.
+       */
+      static bool readRecord(std::istream& stream, Record& record, std::string_view signature = magic);
+
+      /**
+       * @brief Get an interned text.
+       * @param id Id of the text.
+       * @return Interned text, or an empty string if the id is unknown.
+       */
+      static std::string_view text(std::uint32_t id);
+
+      /**
+       * @brief Get an interned text without waiting for the table, which makes it usable from signal handlers.
+       * @param id Id of the text.
+       * @param text Interned text. Unchanged on failure.
+       * @return true on success, false if the id is unknown or the table is locked.
+       */
+      static bool tryText(std::uint32_t id, std::string_view& text);
+
+      /**
+       * @brief Decode the data attached to a message without allocating.
+       * @details Numbers are formatted in a local buffer, so the texts passed to the visitor are only valid during the
+       *          call.
+       * @param payload Encoded data.
+       * @param visitor Function called on every datagram, in order.
+       * @return true if the whole payload was decoded, false if it is malformed.
+       */
+      static bool visitData(std::string_view payload, const Visitor& visitor);
+
+      /**
+       * @brief Append the definition of an interned text to a binary log.
+       * @param output Destination buffer.
+       * @param id Id of the text.
+       * @param text Text.
+       */
+      static void writeFormat(std::string& output, std::uint32_t id, std::string_view text);
+
+      /**
+       * @brief Append a message record to a binary log.
+       * @param output Destination buffer.
+       * @param level Numeric value of the message level.
+       * @param timestamp Timestamp of the message [ns].
+       * @param id Id of the message text, or no_id if the text is stored in the record.
+       * @param text Text of the message, only written if the id is no_id.
+       * @param payload Encoded data of the message.
+       */
+      static void writeMessage(
+         std::string&     output,
+         std::uint8_t     level,
+         long long        timestamp,
+         std::uint32_t    id,
+         std::string_view text,
+         std::string_view payload);
+
+   private:
+      /**
+       * @brief Append a tag and a raw value to the output.
+       */
+      template<typename Output, typename Type>
+      static void appendTagged_(Output& output, ArgType tag, const Type& value)
+      {
+         appendValue_(output, tag);
+         appendValue_(output, value);
+      }
+
+      /**
+       * @brief Append the raw bytes of a value to the output.
+       */
+      template<typename Output, typename Type>
+      static void appendValue_(Output& output, const Type& value)
+      {
+         static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable values can be stored as bytes.");
+
+         output.append(reinterpret_cast<const char*>(&value), sizeof(Type));
+      }
+
+      /**
+       * @brief Encode a description as the id of an interned text, or as no_id followed by the length-prefixed text
+       *        once the budget of non-literal texts is spent.
+       */
+      template<typename Output>
+      static void encodeDescription_(Output& output, LogText description)
+      {
+         std::uint32_t id{ no_id };
+         if (description.isLiteral())
+         {
+            appendValue_(output, intern(description));
+            return;
+         }
+         if (internDynamic(description, id))
+         {
+            appendValue_(output, id);
+            return;
+         }
+
+         appendValue_(output, no_id);
+         appendValue_(output, static_cast<std::uint32_t>(description.size()));
+         output.append(description.data(), description.size());
+      }
+
+      /**
+       * @brief Encode an integer with the tag matching its size and sign.
+       */
+      template<typename Output, typename Type>
+      static void encodeInteger_(Output& output, Type value)
+      {
+         appendTagged_(output, argType<Type>(), value);
+      }
+   };
+} // namespace cjm::data
+
+#endif // COMMON_DATA_BINARYLOG_HPP
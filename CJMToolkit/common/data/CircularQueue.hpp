@@ -26,6 +26,7 @@
 #define COMMON_DATA_CIRCULARQUEUE_HPP
 
 #include <array>
+#include <cstddef>
 
 namespace cjm::data
 {
@@ -43,45 +44,88 @@ namespace cjm::data
        */
       constexpr CircularQueue() = default;
 
+      /**
+       * @brief Access an element of the queue.
+       * @param index Position of the element, starting from the oldest one. Must be lower than size().
+       * @return Reference to the desired element.
+       */
+      constexpr const Type& operator[](size_t index) const
+      {
+         return data_[(popIdx_ + index) % Size];
+      }
+
+      /**
+       * @brief Check whether the queue is empty.
+       * @return true or false.
+       */
+      constexpr bool empty() const
+      {
+         return currentSize_ == 0U;
+      }
+
       /**
        * @brief Push an element into the queue.
+       * @details If the queue is full, the oldest element is overwritten.
        * @param newElement New element tu push into the queue.
        * @return Reference to the newly inserted element.
        */
       constexpr Type& push(const Type& newElement)
       {
-         // Push a new element into the queue.
-         data_[pushIdx_] = newElement;
+         Type& returnValue = pushInPlace();
+         returnValue       = newElement;
+         return returnValue;
+      }
+
+      /**
+       * @brief Push an element into the queue without assigning it.
+       * @details The returned slot still holds the element that was stored there previously, if any, so that the
+       *          caller can rebuild it in place and reuse its resources. If the queue is full, the oldest element is
+       *          overwritten.
+       * @return Reference to the newly inserted element.
+       */
+      constexpr Type& pushInPlace()
+      {
          Type& returnValue = data_[pushIdx_];
 
          ++pushIdx_;
-         ++currentSize_;
 
          // Cycle back to the beginning of the array.
          if (pushIdx_ == data_.size()) pushIdx_ = 0U;
 
-         // Pop an element if the maximum size has been reached.
-         if (currentSize_ > Size)
+         // Drop the oldest element if the maximum size has been reached.
+         if (currentSize_ == Size)
+         {
+            popIdx_ = pushIdx_;
+         }
+         else
          {
-            --currentSize_;
-            pop();
+            ++currentSize_;
          }
 
          return returnValue;
       }
 
       /**
-       * @brief Pop an element from the queue.
+       * @brief Pop the oldest element from the queue.
        */
       constexpr void pop()
       {
          if (currentSize_ == 0U) return;
 
-         if (popIdx_ == 0U) popIdx_ = data_.size();
-         --popIdx_;
+         ++popIdx_;
+         if (popIdx_ == data_.size()) popIdx_ = 0U;
          --currentSize_;
       }
 
+      /**
+       * @brief Get the number of elements in the queue.
+       * @return Number of elements in the queue.
+       */
+      constexpr size_t size() const
+      {
+         return currentSize_;
+      }
+
    private:
       std::array<Type, Size> data_; /**< Actual data contained inside the queue. */
 
@@ -0,0 +1,211 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_DATA_CONCURRENTQUEUE_HPP
+#define COMMON_DATA_CONCURRENTQUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace cjm::data
+{
+   /**
+    * @brief Bounded lock-free queue that supports multiple producers and multiple consumers.
+    * @details Each cell carries a sequence number that tells producers and consumers whether the cell is free or full,
+    *          so threads only contend on the two indices and never on a lock.
+    * @tparam Type Type contained inside the queue.
+    * @tparam Size Size of the queue. Must be a power of two.
+    */
+   template<typename Type, size_t Size>
+   class ConcurrentQueue
+   {
+      static_assert(Size >= 2U && (Size & (Size - 1U)) == 0U, "The size of the queue must be a power of two.");
+
+   public:
+      static constexpr size_t cache_line_size{ 64U }; /**< Size of a cache line, used to avoid false sharing. */
+
+      /**
+       * @brief Default constructor.
+       */
+      ConcurrentQueue()
+      {
+         for (size_t i = 0U; i < Size; ++i)
+         {
+            data_[i].sequence.store(i, std::memory_order_relaxed);
+         }
+      }
+
+      /**
+       * @brief Copy constructor.
+       */
+      ConcurrentQueue(const ConcurrentQueue&) = delete;
+
+      /**
+       * @brief Copy-assignment operator.
+       */
+      ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+      /**
+       * @brief Check whether the queue is empty.
+       * @details The result is only a snapshot and may already be outdated when it is returned.
+       * @return true or false.
+       */
+      bool empty() const
+      {
+         return size() == 0U;
+      }
+
+      /**
+       * @brief Get the approximate number of elements in the queue.
+       * @return Number of elements in the queue.
+       */
+      size_t size() const
+      {
+         size_t pushIdx{ pushIdx_.load(std::memory_order_relaxed) };
+         size_t popIdx{ popIdx_.load(std::memory_order_relaxed) };
+         return pushIdx > popIdx ? pushIdx - popIdx : 0U;
+      }
+
+      /**
+       * @brief Try to extract the oldest element from the queue.
+       * @param element Destination of the extracted element.
+       * @return true on success, false if the queue is empty.
+       */
+      bool tryPop(Type& element)
+      {
+         Cell*  cell{ nullptr };
+         size_t popIdx{ popIdx_.load(std::memory_order_relaxed) };
+
+         while (true)
+         {
+            cell = &data_[popIdx & index_mask];
+            size_t    sequence{ cell->sequence.load(std::memory_order_acquire) };
+            ptrdiff_t difference{ static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(popIdx + 1U) };
+
+            if (difference == 0)
+            {
+               if (popIdx_.compare_exchange_weak(popIdx, popIdx + 1U, std::memory_order_relaxed)) break;
+            }
+            else if (difference < 0)
+            {
+               return false;
+            }
+            else
+            {
+               popIdx = popIdx_.load(std::memory_order_relaxed);
+            }
+         }
+
+         element = std::move(cell->value);
+         cell->sequence.store(popIdx + index_mask + 1U, std::memory_order_release);
+         return true;
+      }
+
+      /**
+       * @brief Try to push an element into the queue.
+       * @param newElement New element to push into the queue. It is moved only on success.
+       * @return true on success, false if the queue is full.
+       */
+      bool tryPush(Type&& newElement)
+      {
+         return tryPush_([&newElement](Type& value) { value = std::move(newElement); });
+      }
+
+      /**
+       * @brief Try to copy an element into the queue.
+       * @details The element is copy-assigned into its slot, so any memory already owned by the slot is reused.
+       * @param newElement New element to push into the queue.
+       * @return true on success, false if the queue is full.
+       */
+      bool tryPush(const Type& newElement)
+      {
+         return tryPush_([&newElement](Type& value) { value = newElement; });
+      }
+
+   private:
+      static constexpr size_t index_mask{ Size - 1U }; /**< Mask used to wrap indices around the array. */
+
+      /**
+       * @brief Single slot of the queue.
+       */
+      struct Cell
+      {
+         std::atomic<size_t> sequence{ 0U }; /**< Sequence number used to synchronise producers and consumers. */
+         Type                value;          /**< Stored element. */
+      };
+
+      /**
+       * @brief Claim a free slot and store an element into it.
+       * @tparam Store Function that stores the element into the slot.
+       * @param store Function to call on the claimed slot.
+       * @return true on success, false if the queue is full.
+       */
+      template<typename Store>
+      bool tryPush_(Store store)
+      {
+         Cell*  cell{ nullptr };
+         size_t pushIdx{ pushIdx_.load(std::memory_order_relaxed) };
+
+         while (true)
+         {
+            cell = &data_[pushIdx & index_mask];
+            size_t    sequence{ cell->sequence.load(std::memory_order_acquire) };
+            ptrdiff_t difference{ static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(pushIdx) };
+
+            if (difference == 0)
+            {
+               if (pushIdx_.compare_exchange_weak(pushIdx, pushIdx + 1U, std::memory_order_relaxed)) break;
+            }
+            else if (difference < 0)
+            {
+               return false;
+            }
+            else
+            {
+               pushIdx = pushIdx_.load(std::memory_order_relaxed);
+            }
+         }
+
+         store(cell->value);
+         cell->sequence.store(pushIdx + 1U, std::memory_order_release);
+         return true;
+      }
+
+      std::array<Cell, Size> data_; /**< Actual data contained inside the queue. */
+
+      /**
+       * @brief Next index where a new element will be stored.
+       */
+      alignas(cache_line_size) std::atomic<size_t> pushIdx_{ 0U };
+
+      /**
+       * @brief Next index from where an element will be extracted.
+       */
+      alignas(cache_line_size) std::atomic<size_t> popIdx_{ 0U };
+   };
+} // namespace cjm::data
+
+#endif // COMMON_DATA_CONCURRENTQUEUE_HPP
@@ -0,0 +1,250 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "LogArchive.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#include <zlib.h>
+
+namespace cjm::data
+{
+   namespace
+   {
+      constexpr size_t max_block_size{ 2U * LogArchive::block_size }; /**< Largest block cut at the marks [B]. */
+
+      /**
+       * @brief Read a raw value from a stream.
+       * @return true on success, false otherwise.
+       */
+      template<typename Type>
+      bool readValue(std::istream& stream, Type& value)
+      {
+         return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(Type)));
+      }
+
+      /**
+       * @brief Write the raw bytes of a value to a stream.
+       */
+      template<typename Type>
+      void writeValue(std::ostream& stream, const Type& value)
+      {
+         stream.write(reinterpret_cast<const char*>(&value), sizeof(Type));
+      }
+   } // namespace
+
+   bool LogArchive::compress(const std::string& source, const std::string& destination, const std::vector<Mark>& marks)
+   {
+      std::ifstream input(source, std::ios::in | std::ios::binary | std::ios::ate);
+      if (!input.is_open()) return false;
+      auto sourceSize{ static_cast<std::uint64_t>(input.tellg()) };
+      input.seekg(0);
+
+      std::string   temporaryName{ destination + ".tmp" };
+      std::ofstream output(temporaryName, std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!output.is_open()) return false;
+      output << magic;
+
+      std::vector<Block> index;
+      std::string        raw;
+      std::string        compressed;
+      auto               mark{ marks.begin() };
+      for (std::uint64_t rawOffset = 0U; rawOffset < sourceSize;)
+      {
+         Block block;
+         block.rawOffset = rawOffset;
+         block.fileOffset = static_cast<std::uint64_t>(output.tellp());
+
+         // Start from the mark at this offset, if any, and stop at the next one unless it is too far away.
+         while (mark != marks.end() && mark->offset < rawOffset) ++mark;
+         if (mark != marks.end() && mark->offset == rawOffset)
+         {
+            block.timestamp = mark->timestamp;
+            ++mark;
+         }
+         std::uint64_t end{ std::min(rawOffset + block_size, sourceSize) };
+         if (mark != marks.end() && mark->offset - rawOffset <= max_block_size) end = mark->offset;
+
+         block.rawSize = static_cast<std::uint32_t>(end - rawOffset);
+         raw.resize(block.rawSize);
+         if (!input.read(raw.data(), static_cast<std::streamsize>(raw.size()))) break;
+
+         uLongf compressedSize{ compressBound(static_cast<uLong>(raw.size())) };
+         compressed.resize(compressedSize);
+         if (compress2(
+                reinterpret_cast<Bytef*>(compressed.data()),
+                &compressedSize,
+                reinterpret_cast<const Bytef*>(raw.data()),
+                static_cast<uLong>(raw.size()),
+                Z_DEFAULT_COMPRESSION) != Z_OK)
+         {
+            break;
+         }
+         block.compressedSize = static_cast<std::uint32_t>(compressedSize);
+         output.write(compressed.data(), static_cast<std::streamsize>(compressedSize));
+
+         index.emplace_back(block);
+         rawOffset = end;
+      }
+
+      std::uint64_t coveredSize{ index.empty() ? 0U : index.back().rawOffset + index.back().rawSize };
+      if (coveredSize != sourceSize)
+      {
+         output.close();
+         std::remove(temporaryName.c_str());
+         return false;
+      }
+
+      auto indexOffset{ static_cast<std::uint64_t>(output.tellp()) };
+      writeValue(output, static_cast<std::uint32_t>(index.size()));
+      for (const auto& block : index)
+      {
+         writeValue(output, static_cast<std::int64_t>(block.timestamp));
+         writeValue(output, block.rawOffset);
+         writeValue(output, block.fileOffset);
+         writeValue(output, block.rawSize);
+         writeValue(output, block.compressedSize);
+      }
+      writeValue(output, indexOffset);
+      output << magic;
+      output.close();
+
+      if (output.fail() || std::rename(temporaryName.c_str(), destination.c_str()) != 0)
+      {
+         std::remove(temporaryName.c_str());
+         return false;
+      }
+      return true;
+   }
+
+   size_t LogArchive::findBlock(const std::vector<Block>& index, long long timestamp)
+   {
+      // Blocks without timestamp are skipped: they continue the block before them. A block that starts at the given
+      // time may follow messages with the same timestamp, so the search stops at the last block starting earlier.
+      size_t found{ 0U };
+      size_t low{ 0U };
+      size_t high{ index.size() };
+      while (low < high)
+      {
+         size_t middle{ low + (high - low) / 2U };
+         size_t probe{ middle };
+         while (probe < high && index[probe].timestamp == no_timestamp) ++probe;
+
+         if (probe == high)
+         {
+            high = middle;
+         }
+         else if (index[probe].timestamp < timestamp)
+         {
+            found = probe;
+            low = probe + 1U;
+         }
+         else
+         {
+            high = middle;
+         }
+      }
+
+      return found;
+   }
+
+   bool LogArchive::isArchive(std::istream& stream)
+   {
+      auto        position{ stream.tellg() };
+      std::string signature(magic.size(), '\0');
+      bool        valid{ stream.read(signature.data(), static_cast<std::streamsize>(signature.size())) &&
+                  (signature == magic || signature == legacy_magic) };
+
+      stream.clear();
+      stream.seekg(position);
+      return valid;
+   }
+
+   bool LogArchive::readBlock(std::istream& stream, const Block& block, std::string& data)
+   {
+      std::string compressed(block.compressedSize, '\0');
+      stream.clear();
+      if (!stream.seekg(static_cast<std::streamoff>(block.fileOffset)) ||
+          !stream.read(compressed.data(), static_cast<std::streamsize>(compressed.size())))
+      {
+         return false;
+      }
+
+      data.resize(block.rawSize);
+      uLongf rawSize{ block.rawSize };
+      if (uncompress(
+             reinterpret_cast<Bytef*>(data.data()),
+             &rawSize,
+             reinterpret_cast<const Bytef*>(compressed.data()),
+             static_cast<uLong>(compressed.size())) != Z_OK)
+      {
+         return false;
+      }
+
+      return rawSize == block.rawSize;
+   }
+
+   bool LogArchive::readIndex(std::istream& stream, std::vector<Block>& index)
+   {
+      index.clear();
+      if (!isArchive(stream)) return false;
+
+      // The trailer is the offset of the index followed by the signature.
+      std::uint64_t indexOffset{ 0U };
+      std::string   signature(magic.size(), '\0');
+      stream.clear();
+      if (!stream.seekg(-static_cast<std::streamoff>(sizeof(indexOffset) + magic.size()), std::ios::end) ||
+          !readValue(stream, indexOffset) ||
+          !stream.read(signature.data(), static_cast<std::streamsize>(signature.size())) ||
+          (signature != magic && signature != legacy_magic))
+      {
+         return false;
+      }
+
+      // Archives of the first version index their blocks in [ms].
+      constexpr long long ns_per_ms{ 1000000 };
+      long long           scale{ signature == legacy_magic ? ns_per_ms : 1 };
+
+      std::uint32_t count{ 0U };
+      if (!stream.seekg(static_cast<std::streamoff>(indexOffset)) || !readValue(stream, count)) return false;
+
+      index.resize(count);
+      for (auto& block : index)
+      {
+         std::int64_t timestamp{ 0 };
+         if (!readValue(stream, timestamp) || !readValue(stream, block.rawOffset) ||
+             !readValue(stream, block.fileOffset) || !readValue(stream, block.rawSize) ||
+             !readValue(stream, block.compressedSize))
+         {
+            index.clear();
+            return false;
+         }
+         block.timestamp = timestamp == no_timestamp ? no_timestamp : timestamp * scale;
+      }
+
+      return true;
+   }
+} // namespace cjm::data
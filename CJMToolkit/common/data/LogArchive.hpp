@@ -0,0 +1,122 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_DATA_LOGARCHIVE_HPP
+#define COMMON_DATA_LOGARCHIVE_HPP
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cjm::data
+{
+   /**
+    * @brief Compressed archive of a rotated log file.
+    * @details The file is split into blocks that are compressed independently with zlib, followed by an index that maps
+    *          the timestamp of the first message of each block to the position of the block. A reader can therefore
+    *          jump to a point in time and decompress only from there.
+    *          Layout: [magic] [block]... [u32 count] [index entry]... [u64 index offset] [magic], where each entry
+    *          is [i64 timestamp] [u64 raw offset] [u64 file offset] [u32 raw size] [u32 compressed size]. All values
+    *          are stored with the byte order of the host.
+    */
+   class LogArchive
+   {
+   public:
+      static constexpr std::string_view magic{ "CJMLZA2\n" };        /**< Signature at both ends of an archive. */
+      static constexpr std::string_view legacy_magic{ "CJMLZA1\n" }; /**< Signature of archives indexed in [ms]. */
+      static constexpr std::string_view extension{ ".cjz" };         /**< Extension of archive files. */
+      static constexpr size_t           block_size{ 1024U * 1024U }; /**< Target size of an uncompressed block [B]. */
+      static constexpr long long        no_timestamp{ -1 };          /**< Timestamp of blocks with unknown start. */
+
+      /**
+       * @brief Position in the uncompressed file where a block can start, at the beginning of a message.
+       */
+      struct Mark
+      {
+         long long     timestamp{ no_timestamp }; /**< Timestamp of the message [ns]. */
+         std::uint64_t offset{ 0U };              /**< Position of the message in the file. */
+      };
+
+      /**
+       * @brief Index entry of a compressed block.
+       */
+      struct Block
+      {
+         long long     timestamp{ no_timestamp }; /**< Timestamp of the first message of the block [ns]. */
+         std::uint64_t rawOffset{ 0U };           /**< Position of the block in the uncompressed file. */
+         std::uint64_t fileOffset{ 0U };          /**< Position of the compressed block in the archive. */
+         std::uint32_t rawSize{ 0U };             /**< Uncompressed size. */
+         std::uint32_t compressedSize{ 0U };      /**< Compressed size. */
+      };
+
+      /**
+       * @brief Compress a file into an archive.
+       * @details Blocks start at the given marks. Without marks, or between marks that are too far apart, blocks are
+       *          cut every block_size bytes and have no timestamp. The archive is written under a temporary name and
+       *          renamed when complete.
+       * @param source Path of the file to compress.
+       * @param destination Path of the archive.
+       * @param marks Possible block starts, sorted by offset.
+       * @return true on success, false otherwise.
+       */
+      static bool
+         compress(const std::string& source, const std::string& destination, const std::vector<Mark>& marks);
+
+      /**
+       * @brief Find the block to start from to read every message from a given time on.
+       * @param index Index of the archive.
+       * @param timestamp Desired time [ns].
+       * @return Index of the last block starting before the given time, or 0.
+       */
+      static size_t findBlock(const std::vector<Block>& index, long long timestamp);
+
+      /**
+       * @brief Check whether a stream contains an archive. The position of the stream is restored.
+       * @param stream Input stream.
+       * @return true or false.
+       */
+      static bool isArchive(std::istream& stream);
+
+      /**
+       * @brief Decompress a block.
+       * @param stream Archive stream.
+       * @param block Index entry of the block.
+       * @param data Uncompressed data.
+       * @return true on success, false if the block is damaged.
+       */
+      static bool readBlock(std::istream& stream, const Block& block, std::string& data);
+
+      /**
+       * @brief Read the index of an archive.
+       * @param stream Archive stream.
+       * @param index Index of the archive, sorted by offset.
+       * @return true on success, false if the stream is not a valid archive.
+       */
+      static bool readIndex(std::istream& stream, std::vector<Block>& index);
+   };
+} // namespace cjm::data
+
+#endif // COMMON_DATA_LOGARCHIVE_HPP
@@ -26,18 +26,47 @@
 
 namespace cjm::data
 {
-   LogMsg::LogMsg(Level level, long long timestamp, std::string_view message) :
-      level_{ level }, timestamp_{ timestamp }, msg_{ message }
+   LogMsg::LogMsg(Level level, long long timestamp, LogText message)
    {
+      reset(level, timestamp, message);
    }
 
-   std::ostream& operator<<(std::ostream& stream, const LogMsg::Level& level)
+   LogMsg::LogMsg(const LogMsg& other)
    {
-      stream << LogMsg::level_keys[static_cast<int>(level)];
-      return stream;
+      copyFrom_(other);
+   }
+
+   LogMsg::LogMsg(LogMsg&& other) noexcept
+   {
+      *this = std::move(other);
+   }
+
+   LogMsg& LogMsg::operator=(const LogMsg& other)
+   {
+      if (this != &other) copyFrom_(other);
+      return *this;
+   }
+
+   LogMsg& LogMsg::operator=(LogMsg&& other) noexcept
+   {
+      if (this == &other) return *this;
+
+      level_       = other.level_;
+      timestamp_   = other.timestamp_;
+      formatId_    = other.formatId_;
+      messageSize_ = other.messageSize_;
+      literal_     = other.literal_;
+      size_        = other.size_;
+      binary_      = other.binary_;
+      spilled_     = other.spilled_;
+      heap_.swap(other.heap_);
+      if (!spilled_) std::memcpy(buffer_.data(), other.buffer_.data(), size_);
+
+      other.reset(Level::trace, 0, LogText{});
+      return *this;
    }
 
-   std::stringstream& operator<<(std::stringstream& stream, const LogMsg::Level& level)
+   std::ostream& operator<<(std::ostream& stream, const LogMsg::Level& level)
    {
       stream << LogMsg::level_keys[static_cast<int>(level)];
       return stream;
@@ -45,17 +74,199 @@ namespace cjm::data
 
    void LogMsg::addData(const Datagram& data)
    {
-      data_.emplace_back(data);
+      addData(data.first, data.second);
    }
 
-   void LogMsg::addData(const std::string& description, const std::string& data)
+   void LogMsg::addData(std::string_view description, std::string_view data)
    {
-      data_.emplace_back(description, data);
+      appendEntry_(description);
+      appendType_(BinaryLog::ArgType::string);
+      appendEntry_(data);
    }
 
    std::string LogMsg::baseMessage() const
    {
-      return std::string(header_begin) + level_keys[static_cast<int>(level_)].data() + separator.data() +
-             std::to_string(timestamp_) + time_unit.data() + header_end.data() + separator.data() + msg_;
+      std::string            message;
+      cjm::fmt::StringOutput output{ message };
+      renderHeader_(output);
+      cjm::fmt::write(output, this->message());
+      return message;
+   }
+
+   bool LogMsg::binary() const
+   {
+      return binary_;
+   }
+
+   std::uint32_t LogMsg::formatId() const
+   {
+      return formatId_;
+   }
+
+   LogMsg::Level LogMsg::level() const
+   {
+      return level_;
+   }
+
+   std::string_view LogMsg::message() const
+   {
+      if (formatId_ != BinaryLog::no_id) return BinaryLog::text(formatId_);
+      return std::string_view(literal_ != nullptr ? literal_ : storage_(), messageSize_);
+   }
+
+   bool LogMsg::parseLevel(std::string_view text, Level& level)
+   {
+      for (size_t i = 0U; i < level_keys.size(); ++i)
+      {
+         if (text == level_keys[i] || text == level_names[i])
+         {
+            level = static_cast<Level>(i);
+            return true;
+         }
+      }
+      return false;
+   }
+
+   std::string_view LogMsg::payload() const
+   {
+      if (!binary_) return std::string_view{};
+      return std::string_view(storage_(), size_).substr(dataOffset_());
+   }
+
+   void LogMsg::reset(Level level, long long timestamp, LogText message)
+   {
+      level_       = level;
+      timestamp_   = timestamp;
+      formatId_    = BinaryLog::no_id;
+      messageSize_ = static_cast<std::uint32_t>(message.size());
+      literal_     = message.isLiteral() ? message.data() : nullptr;
+      size_        = 0U;
+      binary_      = false;
+      spilled_     = false;
+
+      if (literal_ == nullptr) append_(message.data(), message.size());
+   }
+
+   void LogMsg::resetBinary(Level level, long long timestamp, LogText message)
+   {
+      // Only literals are interned, so that the intern table does not grow with every dynamic text.
+      level_       = level;
+      timestamp_   = timestamp;
+      formatId_    = message.isLiteral() ? BinaryLog::intern(message) : BinaryLog::no_id;
+      messageSize_ = formatId_ == BinaryLog::no_id ? static_cast<std::uint32_t>(message.size()) : 0U;
+      literal_     = nullptr;
+      size_        = 0U;
+      binary_      = true;
+      spilled_     = false;
+
+      append_(message.data(), messageSize_);
+   }
+
+   long long LogMsg::timestamp() const
+   {
+      return timestamp_;
+   }
+
+   void LogMsg::append_(const char* data, size_t size)
+   {
+      if (size == 0U) return;
+
+      if (!spilled_ && size_ + size > inline_capacity)
+      {
+         heap_.assign(buffer_.data(), size_);
+         spilled_ = true;
+      }
+
+      if (spilled_)
+      {
+         heap_.append(data, size);
+      }
+      else
+      {
+         std::memcpy(buffer_.data() + size_, data, size);
+      }
+      size_ += static_cast<std::uint32_t>(size);
+   }
+
+   void LogMsg::appendDescription_(LogText description)
+   {
+      if (!description.isLiteral())
+      {
+         appendEntry_(description);
+         return;
+      }
+
+      auto        length{ static_cast<std::uint32_t>(description.size()) | literal_entry };
+      const char* text{ description.data() };
+      append_(reinterpret_cast<const char*>(&length), sizeof(length));
+      append_(reinterpret_cast<const char*>(&text), sizeof(text));
+   }
+
+   void LogMsg::appendEntry_(std::string_view text)
+   {
+      auto length{ static_cast<std::uint32_t>(text.size()) };
+      append_(reinterpret_cast<const char*>(&length), sizeof(length));
+      append_(text.data(), text.size());
+   }
+
+   void LogMsg::appendType_(BinaryLog::ArgType type)
+   {
+      append_(reinterpret_cast<const char*>(&type), sizeof(type));
+   }
+
+   void LogMsg::copyFrom_(const LogMsg& other)
+   {
+      level_       = other.level_;
+      timestamp_   = other.timestamp_;
+      formatId_    = other.formatId_;
+      messageSize_ = other.messageSize_;
+      literal_     = other.literal_;
+      size_        = 0U;
+      binary_      = other.binary_;
+      spilled_     = false;
+
+      append_(other.storage_(), other.size_);
+   }
+
+   size_t LogMsg::dataOffset_() const
+   {
+      return literal_ != nullptr ? 0U : messageSize_;
+   }
+
+   std::string_view LogMsg::readEntry_(std::string_view storage, size_t& offset)
+   {
+      std::uint32_t length{ 0U };
+      std::memcpy(&length, storage.data() + offset, sizeof(length));
+      offset += sizeof(length);
+
+      if ((length & literal_entry) != 0U)
+      {
+         const char* text{ nullptr };
+         std::memcpy(&text, storage.data() + offset, sizeof(text));
+         offset += sizeof(text);
+         return std::string_view(text, length & ~literal_entry);
+      }
+
+      std::string_view text{ storage.substr(offset, length) };
+      offset += length;
+      return text;
+   }
+
+   BinaryLog::ArgType LogMsg::readType_(std::string_view storage, size_t& offset)
+   {
+      BinaryLog::ArgType type{ BinaryLog::ArgType::string };
+      std::memcpy(&type, storage.data() + offset, sizeof(type));
+      offset += sizeof(type);
+      return type;
+   }
+
+   const char* LogMsg::storage_() const
+   {
+      return spilled_ ? heap_.data() : buffer_.data();
+   }
+
+   char* LogMsg::storage_()
+   {
+      return spilled_ ? heap_.data() : buffer_.data();
    }
 } // namespace cjm::data
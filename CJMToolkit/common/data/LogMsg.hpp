@@ -25,16 +25,27 @@
 #ifndef COMMON_DATA_LOGMSG_HPP
 #define COMMON_DATA_LOGMSG_HPP
 
+#include "BinaryLog.hpp"
+#include "LogText.hpp"
+#include "common/format/Format.hpp"
+
 #include <array>
-#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
 #include <string>
 #include <string_view>
-#include <vector>
+#include <type_traits>
+#include <utility>
 
 namespace cjm::data
 {
    /**
     * @brief Data from a logging message.
+    * @details The text and the additional data are stored in a fixed inline buffer. Messages that do not fit spill
+    *          into a heap buffer whose capacity is kept when the message is reset, so a message that is rebuilt in
+    *          place does not allocate once it has seen its largest content. Texts and descriptions marked as literals
+    *          with LogText are not copied, only their pointer is kept.
     */
    class LogMsg
    {
@@ -60,11 +71,28 @@ namespace cjm::data
          "TRC", "INF", "WRN", "ERR", "FTL"
       };
 
+      /**
+       * @brief Names of the logging levels, as used in settings.
+       */
+      static constexpr std::array<std::string_view, static_cast<size_t>(Level::fatal) + 1> level_names{
+         "trace", "info", "warn", "error", "fatal"
+      };
+
       static constexpr std::string_view time_unit{ "ms" };   /**< Time unit of measurement. */
+      static constexpr std::string_view time_point{ "." };   /**< Separator of the fractions of a millisecond. */
       static constexpr std::string_view header_begin{ "[" }; /**< Beginning of the message header. */
       static constexpr std::string_view header_end{ "]" };   /**< End of the message header. */
       static constexpr std::string_view separator{ " - " };  /**< Separator between header elements. */
 
+      static constexpr std::string_view data_separator{ " " };  /**< Separator before each datagram. */
+      static constexpr std::string_view data_assignment{ "=" }; /**< Separator between a description and its data. */
+      static constexpr char             data_quote{ '"' };      /**< Quote for datagram texts containing separators. */
+      static constexpr char             data_escape{ '\\' };    /**< Escape character inside quoted datagram texts. */
+
+      static constexpr size_t inline_capacity{ 192U }; /**< Bytes of text and data stored inside the message. */
+
+      static constexpr std::uint32_t literal_entry{ 0x80000000U }; /**< Flag of entries that point to a literal. */
+
       /**
        * @brief Default constructor.
        */
@@ -73,14 +101,32 @@ namespace cjm::data
       /**
        * @brief Constructor.
        * @param level Error level of the message.
-       * @param timestame Timestamp of the message [ms].
-       * @param message Text message.
+       * @param timestame Timestamp of the message [ns].
+       * @param message Text message. Copied, unless it is marked as a literal.
        */
-      LogMsg(Level level, long long timestamp, std::string_view message);
+      LogMsg(Level level, long long timestamp, LogText message);
 
-      friend std::ostream& operator<<(std::ostream& stream, const LogMsg::Level& level);
+      /**
+       * @brief Copy constructor. Only the used part of the buffer is copied.
+       */
+      LogMsg(const LogMsg& other);
+
+      /**
+       * @brief Move constructor.
+       */
+      LogMsg(LogMsg&& other) noexcept;
+
+      /**
+       * @brief Copy-assignment operator. Reuses the heap buffer of the destination, if any.
+       */
+      LogMsg& operator=(const LogMsg& other);
+
+      /**
+       * @brief Move-assignment operator. Swaps the heap buffers, so no memory is released.
+       */
+      LogMsg& operator=(LogMsg&& other) noexcept;
 
-      friend std::stringstream& operator<<(std::stringstream& stream, const LogMsg::Level& level);
+      friend std::ostream& operator<<(std::ostream& stream, const LogMsg::Level& level);
 
       /**
        * @brief Add further details to the message.
@@ -93,7 +139,7 @@ namespace cjm::data
        * @param description Description of the data.
        * @param data Data to be stored.
        */
-      void addData(const std::string& description, const std::string& data);
+      void addData(std::string_view description, std::string_view data);
 
       /**
        * @brief Add further details to the message.
@@ -104,12 +150,28 @@ namespace cjm::data
       template<typename DescriptionType, typename DataType>
       void addData(const std::pair<DescriptionType, DataType> data)
       {
-         std::stringstream descriptionStream;
-         descriptionStream << data.first;
-         std::stringstream dataStream;
-         dataStream << data.second;
+         appendDescription_(data.first);
+         appendFormatted_(data.second);
+      }
 
-         data_.emplace_back(descriptionStream.str(), dataStream.str());
+      /**
+       * @brief Add further details to a binary message, without converting them to text.
+       * @tparam Type of the description.
+       * @tparam Type of the data.
+       * @param data Data to be stored.
+       */
+      template<typename DescriptionType, typename DataType>
+      void addBinaryData(const std::pair<DescriptionType, DataType> data)
+      {
+         Writer writer{ *this };
+         if constexpr (std::is_same_v<std::decay_t<DataType>, Level>)
+         {
+            BinaryLog::encodeLevel(writer, data.first, static_cast<std::uint8_t>(data.second));
+         }
+         else
+         {
+            BinaryLog::encodeData(writer, data.first, data.second);
+         }
       }
 
       /**
@@ -118,12 +180,395 @@ namespace cjm::data
        */
       std::string baseMessage() const;
 
+      /**
+       * @brief Check whether the message is stored in binary form.
+       * @return true or false.
+       */
+      bool binary() const;
+
+      /**
+       * @brief Call a function on every datagram of the message.
+       * @details The data of binary messages is decoded one datagram at a time, so the texts passed to the function
+       *          are only valid during the call.
+       * @tparam Callable Function that accepts the description and the data as std::string_view.
+       * @param function Function to call.
+       */
+      template<typename Callable>
+      void forEachData(Callable function) const
+      {
+         forEachField([&function](std::string_view description, BinaryLog::ArgType, std::string_view data) {
+            function(description, data);
+         });
+      }
+
+      /**
+       * @brief Call a function on every datagram of the message, with the type the data had when it was added.
+       * @details The data of binary messages is decoded one datagram at a time, so the texts passed to the function
+       *          are only valid during the call.
+       * @tparam Callable Function that accepts the description as std::string_view, the type as BinaryLog::ArgType
+       *                  and the data as std::string_view.
+       * @param function Function to call.
+       */
+      template<typename Callable>
+      void forEachField(Callable function) const
+      {
+         if (binary())
+         {
+            BinaryLog::visitData(payload(), [&function](const BinaryLog::Field& field) {
+               bool interned{ field.descriptionId != BinaryLog::no_id };
+               function(interned ? BinaryLog::text(field.descriptionId) : field.description, field.type, field.value);
+            });
+            return;
+         }
+
+         std::string_view storage{ storage_(), size_ };
+         size_t           offset{ dataOffset_() };
+         while (offset < storage.size())
+         {
+            std::string_view   description{ readEntry_(storage, offset) };
+            BinaryLog::ArgType type{ readType_(storage, offset) };
+            std::string_view   data{ readEntry_(storage, offset) };
+            function(description, type, data);
+         }
+      }
+
+      /**
+       * @brief Get the id of the message text.
+       * @return Id of the interned message text, or BinaryLog::no_id if the text is stored in the message.
+       */
+      std::uint32_t formatId() const;
+
+      /**
+       * @brief Get the level of the message.
+       * @return Level of the message.
+       */
+      Level level() const;
+
+      /**
+       * @brief Get the text of the message.
+       * @return Text of the message. For binary messages, the interned text.
+       */
+      std::string_view message() const;
+
+      /**
+       * @brief Convert a text into a logging level.
+       * @param text Name or keyword of the level.
+       * @param level Parsed level. Unchanged on failure.
+       * @return true on success, false if the text is not a level.
+       */
+      static bool parseLevel(std::string_view text, Level& level);
+
+      /**
+       * @brief Get the encoded data of a binary message.
+       * @return Encoded data.
+       */
+      std::string_view payload() const;
+
+      /**
+       * @brief Write the complete message in a single pass: header, text and datagrams as description=data.
+       * @details Descriptions and data that are empty or contain spaces, '=', quotes or control characters are quoted.
+       *          Inside quotes, quotes and backslashes are escaped with a backslash. In the text and in the datagrams,
+       *          line breaks and tabs are written as \\n, \\r and \\t and other control characters as \\xNN, so
+       *          every record stays on one line.
+       * @tparam Output Type of the output, with a member append(const char*, size_t).
+       * @param output Destination of the text.
+       */
+      template<typename Output>
+      void render(Output& output) const
+      {
+         renderHeader_(output);
+         renderEscaped_(output, message(), false);
+         forEachData([&output](std::string_view description, std::string_view data) {
+            cjm::fmt::write(output, data_separator);
+            renderText_(output, description);
+            cjm::fmt::write(output, data_assignment);
+            renderText_(output, data);
+         });
+      }
+
+      /**
+       * @brief Write a timestamp in milliseconds, with the nanoseconds as decimals.
+       * @tparam Output Type of the output.
+       * @param output Destination of the text.
+       * @param timestamp Timestamp [ns].
+       */
+      template<typename Output>
+      static void renderTime(Output& output, long long timestamp)
+      {
+         constexpr long long ns_per_ms{ 1000000 };
+
+         if (timestamp < 0)
+         {
+            cjm::fmt::write(output, "-");
+            timestamp = -timestamp;
+         }
+         cjm::fmt::writeNumber(output, timestamp / ns_per_ms);
+         cjm::fmt::write(output, time_point);
+         cjm::fmt::writeZeroPadded(output, static_cast<std::uint64_t>(timestamp % ns_per_ms), 6U);
+         cjm::fmt::write(output, time_unit);
+      }
+
+      /**
+       * @brief Rebuild the message in place, keeping the heap buffer of previous contents.
+       * @param level Error level of the message.
+       * @param timestamp Timestamp of the message [ns].
+       * @param message Text message. Copied, unless it is marked as a literal.
+       */
+      void reset(Level level, long long timestamp, LogText message);
+
+      /**
+       * @brief Rebuild the message in place as a binary message, whose text and data are never formatted until they
+       *        are written. The heap buffer of previous contents is kept.
+       * @param level Error level of the message.
+       * @param timestamp Timestamp of the message [ns].
+       * @param message Text message. Interned if it is marked as a literal, otherwise copied.
+       */
+      void resetBinary(Level level, long long timestamp, LogText message);
+
+      /**
+       * @brief Get the timestamp of the message.
+       * @return Timestamp of the message [ns].
+       */
+      long long timestamp() const;
+
    private:
-      Level                 level_{ Level::trace }; /**< Level of the message. */
-      long long             timestamp_{ 0U };       /**< Timespamt of the message. */
-      std::string           msg_;                   /**< Actual text message. */
-      std::vector<Datagram> data_;                  /**< Additional data attached to the message. */
+      /**
+       * @brief Adapter that lets BinaryLog append encoded data to the message.
+       */
+      struct Writer
+      {
+         LogMsg& message; /**< Destination message. */
+
+         /**
+          * @brief Append bytes to the message.
+          */
+         void append(const char* data, size_t size)
+         {
+            message.append_(data, size);
+         }
+      };
+
+      /**
+       * @brief Append bytes to the storage, spilling to the heap buffer when the inline buffer is full.
+       * @param data Bytes to append.
+       * @param size Number of bytes.
+       */
+      void append_(const char* data, size_t size);
+
+      /**
+       * @brief Append the description of a datagram to the storage.
+       * @details A string literal is stored as a pointer, in an entry whose length is flagged with literal_entry.
+       * @param description Description to append.
+       */
+      void appendDescription_(LogText description);
+
+      /**
+       * @brief Append a length-prefixed text entry to the storage.
+       * @param text Text to append.
+       */
+      void appendEntry_(std::string_view text);
+
+      /**
+       * @brief Format a value directly into the storage as a length-prefixed text entry, preceded by its type.
+       * @tparam Type Type of the value.
+       * @param value Value to format.
+       */
+      template<typename Type>
+      void appendFormatted_(const Type& value)
+      {
+         if constexpr (std::is_same_v<std::decay_t<Type>, Level>)
+         {
+            appendType_(BinaryLog::ArgType::level);
+         }
+         else
+         {
+            appendType_(BinaryLog::argType<Type>());
+         }
+
+         // Reserve the length and fill it in once the size of the text is known.
+         size_t        lengthOffset{ size_ };
+         std::uint32_t length{ 0U };
+         append_(reinterpret_cast<const char*>(&length), sizeof(length));
+
+         Writer writer{ *this };
+         cjm::fmt::format(writer, value);
+
+         length = static_cast<std::uint32_t>(size_ - lengthOffset - sizeof(length));
+         std::memcpy(storage_() + lengthOffset, &length, sizeof(length));
+      }
+
+      /**
+       * @brief Append the type of a datagram to the storage.
+       * @param type Type of the data that follows.
+       */
+      void appendType_(BinaryLog::ArgType type);
+
+      /**
+       * @brief Copy the contents of another message, without its heap buffer.
+       * @param other Message to copy.
+       */
+      void copyFrom_(const LogMsg& other);
+
+      /**
+       * @brief Get the position of the first datagram in the storage.
+       * @return Offset of the first datagram.
+       */
+      size_t dataOffset_() const;
+
+      /**
+       * @brief Read a length-prefixed text entry, or the literal an entry points to.
+       * @param storage Storage of the message.
+       * @param offset Position of the entry, moved past it.
+       * @return Text of the entry.
+       */
+      static std::string_view readEntry_(std::string_view storage, size_t& offset);
+
+      /**
+       * @brief Read the type of a datagram.
+       * @param storage Storage of the message.
+       * @param offset Position of the type, moved past it.
+       * @return Type of the data that follows.
+       */
+      static BinaryLog::ArgType readType_(std::string_view storage, size_t& offset);
+
+      /**
+       * @brief Write the header of the message.
+       * @tparam Output Type of the output.
+       * @param output Destination of the text.
+       */
+      template<typename Output>
+      void renderHeader_(Output& output) const
+      {
+         cjm::fmt::write(output, header_begin);
+         cjm::fmt::write(output, level_keys[static_cast<size_t>(level_)]);
+         cjm::fmt::write(output, separator);
+         renderTime(output, timestamp_);
+         cjm::fmt::write(output, header_end);
+         cjm::fmt::write(output, separator);
+      }
+
+      /**
+       * @brief Write a datagram text, quoting and escaping it if it contains separators or control characters.
+       * @tparam Output Type of the output.
+       * @param output Destination of the text.
+       * @param text Text to write.
+       */
+      template<typename Output>
+      static void renderText_(Output& output, std::string_view text)
+      {
+         auto special = [](char character) {
+            return character == ' ' || character == '=' || character == data_quote ||
+                   static_cast<unsigned char>(character) < 0x20U || character == '\x7F';
+         };
+
+         size_t begin{ 0U };
+         while (begin < text.size() && !special(text[begin]))
+         {
+            ++begin;
+         }
+         if (!text.empty() && begin == text.size())
+         {
+            cjm::fmt::write(output, text);
+            return;
+         }
+
+         // A backslash alone leaves the text unquoted, it is only escaped inside quotes.
+         output.append(&data_quote, 1U);
+         renderEscaped_(output, text, true);
+         output.append(&data_quote, 1U);
+      }
+
+      /**
+       * @brief Write a text, escaping its control characters.
+       * @tparam Output Type of the output.
+       * @param output Destination of the text.
+       * @param text Text to write.
+       * @param quoted If true, the text is inside quotes and its quotes and backslashes are escaped too.
+       */
+      template<typename Output>
+      static void renderEscaped_(Output& output, std::string_view text, bool quoted)
+      {
+         constexpr std::string_view hex_digits{ "0123456789ABCDEF" };
+
+         size_t begin{ 0U };
+         for (size_t i = 0U; i < text.size(); ++i)
+         {
+            unsigned char character{ static_cast<unsigned char>(text[i]) };
+            if (character >= 0x20U && character != 0x7FU &&
+                (!quoted || (character != data_quote && character != data_escape)))
+            {
+               continue;
+            }
+
+            output.append(text.data() + begin, i - begin);
+            begin = i + 1U;
+            switch (character)
+            {
+            case '\n':
+               cjm::fmt::write(output, "\\n");
+               break;
+            case '\r':
+               cjm::fmt::write(output, "\\r");
+               break;
+            case '\t':
+               cjm::fmt::write(output, "\\t");
+               break;
+            case data_quote:
+            case data_escape:
+               output.append(&data_escape, 1U);
+               output.append(text.data() + i, 1U);
+               break;
+            default:
+            {
+               const char escape[]{ data_escape, 'x', hex_digits[character >> 4U], hex_digits[character & 0x0FU] };
+               output.append(escape, sizeof(escape));
+               break;
+            }
+            }
+         }
+         output.append(text.data() + begin, text.size() - begin);
+      }
+
+      /**
+       * @brief Get the storage currently in use.
+       * @return Pointer to the first byte of the storage.
+       */
+      const char* storage_() const;
+
+      /**
+       * @brief Get the storage currently in use.
+       * @return Pointer to the first byte of the storage.
+       */
+      char* storage_();
+
+      Level         level_{ Level::trace };        /**< Level of the message. */
+      long long     timestamp_{ 0U };              /**< Timespamt of the message [ns]. */
+      std::uint32_t formatId_{ BinaryLog::no_id }; /**< Id of the interned text of a binary message. */
+      std::uint32_t messageSize_{ 0U };            /**< Size of the text message, stored first unless referenced. */
+      const char*   literal_{ nullptr };           /**< Text message if it is a literal, otherwise nullptr. */
+      std::uint32_t size_{ 0U };                   /**< Bytes used in the storage. */
+      bool          binary_{ false };              /**< true if the data is encoded with BinaryLog. */
+      bool          spilled_{ false };             /**< true if the storage moved to the heap buffer. */
+
+      std::array<char, inline_capacity> buffer_; /**< Inline storage for the text and the data. */
+      std::string                       heap_;   /**< Heap storage for messages that exceed the inline buffer. */
    };
 } // namespace cjm::data
 
+namespace cjm::fmt
+{
+   /**
+    * @brief Formatter for logging levels, written as their keyword.
+    */
+   template<>
+   struct Formatter<cjm::data::LogMsg::Level>
+   {
+      template<typename Output>
+      static void format(Output& output, cjm::data::LogMsg::Level level)
+      {
+         write(output, cjm::data::LogMsg::level_keys[static_cast<size_t>(level)]);
+      }
+   };
+} // namespace cjm::fmt
+
 #endif // COMMON_DATA_LOGMSG_HPP
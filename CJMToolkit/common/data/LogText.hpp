@@ -0,0 +1,161 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_DATA_LOGTEXT_HPP
+#define COMMON_DATA_LOGTEXT_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace cjm::data
+{
+   class LogText;
+
+   namespace log_literals
+   {
+      constexpr LogText operator""_lt(const char* text, size_t size);
+   }
+
+   /**
+    * @brief View of a logging text that remembers whether it is a string literal.
+    * @details Literals live as long as the program, so a message only keeps a pointer to them. Literal storage is
+    *          opt-in, through LogText::literal or the _lt suffix, which the CJM_LOG_* macros apply to their message.
+    *          Descriptions of datagrams and messages passed directly to Log should carry the suffix as well. Any other
+    *          text, including character arrays, is copied into the message when it is built.
+    */
+   class LogText
+   {
+   public:
+      /**
+       * @brief Default constructor. Creates an empty text.
+       */
+      constexpr LogText() = default;
+
+      /**
+       * @brief Constructor from any text, whose contents are copied.
+       * @tparam Type Type of the text, convertible to std::string_view.
+       * @param text Text.
+       */
+      template<
+         typename Type,
+         typename = std::enable_if_t<
+            !std::is_same_v<Type, LogText> && std::is_convertible_v<const Type&, std::string_view>>>
+      constexpr LogText(const Type& text) : LogText(std::string_view(text), false)
+      {
+      }
+
+      /**
+       * @brief Get the characters of the text.
+       * @return Characters of the text, not necessarily null-terminated.
+       */
+      constexpr const char* data() const
+      {
+         return data_;
+      }
+
+      /**
+       * @brief Check whether the text is a string literal, which can be kept by pointer.
+       * @return true or false.
+       */
+      constexpr bool isLiteral() const
+      {
+         return literal_;
+      }
+
+      /**
+       * @brief Create a text that is kept by pointer.
+       * @details The caller guarantees that the text lives as long as the program, the array must not be on the stack
+       *          or in a temporary object.
+       * @tparam Size Size of the array.
+       * @param text String literal, or any other null-terminated array with static storage duration.
+       * @return Literal text.
+       */
+      template<size_t Size>
+      static constexpr LogText literal(const char (&text)[Size])
+      {
+         return LogText(std::string_view(text, std::char_traits<char>::length(text)), true);
+      }
+
+      /**
+       * @brief Get the size of the text.
+       * @return Number of characters.
+       */
+      constexpr size_t size() const
+      {
+         return size_;
+      }
+
+      /**
+       * @brief Get the text as a view.
+       * @return View of the text.
+       */
+      constexpr std::string_view view() const
+      {
+         return std::string_view(data_, size_);
+      }
+
+      /**
+       * @brief Convert the text to a view.
+       */
+      constexpr operator std::string_view() const
+      {
+         return view();
+      }
+
+   private:
+      friend constexpr LogText log_literals::operator""_lt(const char* text, size_t size);
+
+      /**
+       * @brief Constructor.
+       * @param text Text.
+       * @param literal Whether the text is a string literal.
+       */
+      constexpr LogText(std::string_view text, bool literal) :
+         data_{ text.data() }, size_{ text.size() }, literal_{ literal }
+      {
+      }
+
+      const char* data_{ "" };       /**< Characters of the text. */
+      size_t      size_{ 0U };       /**< Number of characters. */
+      bool        literal_{ false }; /**< Whether the text is a string literal. */
+   };
+
+   namespace log_literals
+   {
+      /**
+       * @brief Create a text that is kept by pointer from a string literal.
+       * @param text String literal.
+       * @param size Size of the literal.
+       * @return Literal text.
+       */
+      constexpr LogText operator""_lt(const char* text, size_t size)
+      {
+         return LogText(std::string_view(text, size), true);
+      }
+   } // namespace log_literals
+} // namespace cjm::data
+
+#endif // COMMON_DATA_LOGTEXT_HPP
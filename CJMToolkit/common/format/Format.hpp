@@ -0,0 +1,299 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_FORMAT_FORMAT_HPP
+#define COMMON_FORMAT_FORMAT_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Text formatting of logging data.
+ * @details Values are written directly into a caller-provided output: any object with a member
+ *          append(const char* data, size_t size). Numbers are converted with std::to_chars, so formatting neither
+ *          allocates nor depends on the current locale. Other types are supported by specialising Formatter.
+ */
+namespace cjm::fmt
+{
+   static constexpr std::string_view true_text{ "true" };    /**< Text of a true boolean. */
+   static constexpr std::string_view false_text{ "false" };  /**< Text of a false boolean. */
+   static constexpr std::string_view null_text{ "(null)" };  /**< Text of a null pointer. */
+   static constexpr std::string_view pointer_prefix{ "0x" }; /**< Prefix of pointer addresses. */
+
+   static constexpr size_t number_size{ 32U }; /**< Maximum size of a formatted number. */
+
+   /**
+    * @brief Output that appends to a std::string.
+    */
+   struct StringOutput
+   {
+      std::string& string; /**< Destination string. */
+
+      /**
+       * @brief Append text to the string.
+       * @param data Text to append.
+       * @param size Size of the text.
+       */
+      void append(const char* data, size_t size)
+      {
+         string.append(data, size);
+      }
+   };
+
+   /**
+    * @brief Write a text into an output.
+    * @tparam Output Type of the output.
+    * @param output Destination of the text.
+    * @param text Text to write.
+    */
+   template<typename Output>
+   void write(Output& output, std::string_view text)
+   {
+      output.append(text.data(), text.size());
+   }
+
+   /**
+    * @brief Write a number into an output.
+    * @tparam Output Type of the output.
+    * @tparam Number Arithmetic type.
+    * @param output Destination of the text.
+    * @param value Number to write.
+    * @param base Base of integer numbers.
+    */
+   template<typename Output, typename Number>
+   void writeNumber(Output& output, Number value, int base = 10)
+   {
+      char                 buffer[number_size];
+      std::to_chars_result result;
+      if constexpr (std::is_floating_point_v<Number>)
+      {
+         result = std::to_chars(buffer, buffer + number_size, value);
+      }
+      else
+      {
+         result = std::to_chars(buffer, buffer + number_size, value, base);
+      }
+      output.append(buffer, static_cast<size_t>(result.ptr - buffer));
+   }
+
+   /**
+    * @brief Write an unsigned integer into an output, padded with leading zeros.
+    * @tparam Output Type of the output.
+    * @param output Destination of the text.
+    * @param value Number to write.
+    * @param width Minimum number of digits, at most number_size.
+    */
+   template<typename Output>
+   void writeZeroPadded(Output& output, std::uint64_t value, size_t width)
+   {
+      static constexpr std::string_view zeros{ "00000000000000000000000000000000" };
+      static_assert(zeros.size() == number_size, "One zero per digit of a formatted number.");
+
+      char buffer[number_size];
+      auto result{ std::to_chars(buffer, buffer + number_size, value) };
+      auto size{ static_cast<size_t>(result.ptr - buffer) };
+      if (size < width) output.append(zeros.data(), std::min(width, number_size) - size);
+      output.append(buffer, size);
+   }
+
+   /**
+    * @brief Customisation point for the formatting of a type.
+    * @details Specialisations provide a static template<typename Output> void format(Output&, const Type&).
+    *          The primary template falls back to operator<<, which is slower and allocates.
+    * @tparam Type Type to format.
+    */
+   template<typename Type, typename Enable = void>
+   struct Formatter
+   {
+      template<typename Output>
+      static void format(Output& output, const Type& value)
+      {
+         std::ostringstream stream;
+         stream << value;
+         write(output, stream.str());
+      }
+   };
+
+   /**
+    * @brief Formatter for booleans.
+    */
+   template<>
+   struct Formatter<bool>
+   {
+      template<typename Output>
+      static void format(Output& output, bool value)
+      {
+         write(output, value ? true_text : false_text);
+      }
+   };
+
+   /**
+    * @brief Formatter for characters, written as they are.
+    */
+   template<>
+   struct Formatter<char>
+   {
+      template<typename Output>
+      static void format(Output& output, char value)
+      {
+         output.append(&value, 1U);
+      }
+   };
+
+   /**
+    * @brief Formatter for numbers. 8-bit integers are written as numbers.
+    */
+   template<typename Type>
+   struct Formatter<Type, std::enable_if_t<std::is_arithmetic_v<Type>>>
+   {
+      template<typename Output>
+      static void format(Output& output, Type value)
+      {
+         if constexpr (std::is_integral_v<Type> && sizeof(Type) == 1U)
+         {
+            writeNumber(output, static_cast<int>(value));
+         }
+         else
+         {
+            writeNumber(output, value);
+         }
+      }
+   };
+
+   /**
+    * @brief Formatter for enumerations without a dedicated formatter, written as their underlying value.
+    */
+   template<typename Type>
+   struct Formatter<Type, std::enable_if_t<std::is_enum_v<Type>>>
+   {
+      template<typename Output>
+      static void format(Output& output, Type value)
+      {
+         Formatter<std::underlying_type_t<Type>>::format(output, static_cast<std::underlying_type_t<Type>>(value));
+      }
+   };
+
+   /**
+    * @brief Formatter for string views.
+    */
+   template<>
+   struct Formatter<std::string_view>
+   {
+      template<typename Output>
+      static void format(Output& output, std::string_view value)
+      {
+         write(output, value);
+      }
+   };
+
+   /**
+    * @brief Formatter for strings.
+    */
+   template<>
+   struct Formatter<std::string>
+   {
+      template<typename Output>
+      static void format(Output& output, const std::string& value)
+      {
+         write(output, value);
+      }
+   };
+
+   /**
+    * @brief Formatter for C strings.
+    */
+   template<>
+   struct Formatter<const char*>
+   {
+      template<typename Output>
+      static void format(Output& output, const char* value)
+      {
+         write(output, value == nullptr ? null_text : std::string_view(value));
+      }
+   };
+
+   /**
+    * @brief Formatter for mutable C strings.
+    */
+   template<>
+   struct Formatter<char*> : Formatter<const char*>
+   {
+   };
+
+   /**
+    * @brief Formatter for other pointers, written as hexadecimal addresses.
+    */
+   template<typename Type>
+   struct Formatter<Type*>
+   {
+      template<typename Output>
+      static void format(Output& output, const Type* value)
+      {
+         if (value == nullptr)
+         {
+            write(output, null_text);
+            return;
+         }
+
+         write(output, pointer_prefix);
+         writeNumber(output, reinterpret_cast<std::uintptr_t>(value), 16);
+      }
+   };
+
+   /**
+    * @brief Format a value into an output.
+    * @tparam Output Type of the output.
+    * @tparam Type Type of the value. Arrays decay to pointers, so string literals are formatted as C strings.
+    * @param output Destination of the text.
+    * @param value Value to format.
+    */
+   template<typename Output, typename Type>
+   void format(Output& output, const Type& value)
+   {
+      Formatter<std::decay_t<const Type>>::format(output, value);
+   }
+
+   /**
+    * @brief Format a value into a new string.
+    * @tparam Type Type of the value.
+    * @param value Value to format.
+    * @return Formatted value.
+    */
+   template<typename Type>
+   std::string toString(const Type& value)
+   {
+      std::string  string;
+      StringOutput output{ string };
+      format(output, value);
+      return string;
+   }
+} // namespace cjm::fmt
+
+#endif // COMMON_FORMAT_FORMAT_HPP
@@ -0,0 +1,55 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_CONSOLESINK_HPP
+#define COMMON_IO_CONSOLESINK_HPP
+
+#include "LogSink.hpp"
+
+namespace cjm::io
+{
+   /**
+    * @brief Sink that writes messages on the standard output, coloured by level with ANSI codes.
+    */
+   class ConsoleSink : public LogSink
+   {
+   public:
+      static constexpr std::string_view type{ "console" }; /**< Type of the sink in the settings. */
+
+   protected:
+      /**
+       * @brief Flush the standard output.
+       */
+      void flush_() override;
+
+      /**
+       * @brief Write a message on the standard output.
+       * @param message Message to write.
+       * @param text Rendered message, terminated by a new line.
+       */
+      void write_(const LogMsg& message, std::string_view text) override;
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_CONSOLESINK_HPP
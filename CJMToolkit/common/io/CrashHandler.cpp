@@ -0,0 +1,272 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "CrashHandler.hpp"
+
+#include "Log.hpp"
+#include "common/data/BinaryLog.hpp"
+#include "common/format/Format.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace cjm::io
+{
+   using cjm::data::BinaryLog;
+   using cjm::data::LogMsg;
+
+   namespace
+   {
+      /**
+       * @brief Output that collects text in a fixed buffer and writes it to a file descriptor with write(2).
+       */
+      struct FdOutput
+      {
+         int                                                fd;         /**< Destination file descriptor. */
+         std::array<char, CrashHandler::output_buffer_size> buffer{};   /**< Text not written yet. */
+         size_t                                             size{ 0U }; /**< Size of the text not written yet. */
+
+         /**
+          * @brief Append text, writing the buffer out whenever it is full.
+          * @param data Text to append.
+          * @param length Size of the text.
+          */
+         void append(const char* data, size_t length)
+         {
+            while (length > 0U)
+            {
+               if (size == buffer.size()) flush();
+
+               size_t chunk{ std::min(length, buffer.size() - size) };
+               std::memcpy(buffer.data() + size, data, chunk);
+               size += chunk;
+               data += chunk;
+               length -= chunk;
+            }
+         }
+
+         /**
+          * @brief Write the buffered text. Text that cannot be written is discarded.
+          */
+         void flush()
+         {
+            size_t offset{ 0U };
+            while (offset < size)
+            {
+               ssize_t written{ ::write(fd, buffer.data() + offset, size - offset) };
+               if (written < 0 && errno == EINTR) continue;
+               if (written <= 0) break;
+               offset += static_cast<size_t>(written);
+            }
+            size = 0U;
+         }
+      };
+
+      /**
+       * @brief Names of the handled signals.
+       */
+      constexpr std::array<std::string_view, CrashHandler::signals.size()> signal_names{
+         "SIGSEGV", "SIGABRT", "SIGBUS", "SIGFPE"
+      };
+
+      alignas(16) std::array<char, CrashHandler::stack_size> alternate_stack; /**< Stack of the signal handler. */
+
+      /**
+       * @brief Write a message without locking or allocating.
+       * @details Binary messages are decoded directly. Interned texts that cannot be looked up because the intern
+       *          table is locked are replaced by their id.
+       * @param output Destination of the text.
+       * @param message Message to write.
+       */
+      void writeMessage(FdOutput& output, const LogMsg& message)
+      {
+         if (!message.binary())
+         {
+            message.render(output);
+            cjm::fmt::write(output, "\n");
+            return;
+         }
+
+         cjm::fmt::write(output, LogMsg::header_begin);
+         cjm::fmt::write(output, LogMsg::level_keys[static_cast<size_t>(message.level())]);
+         cjm::fmt::write(output, LogMsg::separator);
+         LogMsg::renderTime(output, message.timestamp());
+         cjm::fmt::write(output, LogMsg::header_end);
+         cjm::fmt::write(output, LogMsg::separator);
+
+         auto writeText = [&output](std::uint32_t id) {
+            std::string_view text;
+            if (BinaryLog::tryText(id, text))
+            {
+               cjm::fmt::write(output, text);
+            }
+            else
+            {
+               cjm::fmt::write(output, "#");
+               cjm::fmt::writeNumber(output, id);
+            }
+         };
+
+         if (message.formatId() == BinaryLog::no_id)
+         {
+            cjm::fmt::write(output, message.message());
+         }
+         else
+         {
+            writeText(message.formatId());
+         }
+         BinaryLog::visitData(message.payload(), [&output, &writeText](const BinaryLog::Field& field) {
+            cjm::fmt::write(output, LogMsg::data_separator);
+            if (field.descriptionId == BinaryLog::no_id)
+            {
+               cjm::fmt::write(output, field.description);
+            }
+            else
+            {
+               writeText(field.descriptionId);
+            }
+            cjm::fmt::write(output, LogMsg::data_assignment);
+            cjm::fmt::write(output, field.value);
+         });
+         cjm::fmt::write(output, "\n");
+      }
+   } // namespace
+
+   /********** STATIC VARIABLES DEFINITIONS **********/
+   std::atomic<int>                                           CrashHandler::fd_{ -1 };
+   std::array<struct sigaction, CrashHandler::signals.size()> CrashHandler::previous_;
+
+   /********** METHOD DEFINITIONS **********/
+   bool CrashHandler::install(std::string_view fileName)
+   {
+      int fd{ ::open(std::string(fileName).c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644) };
+      if (fd < 0) return false;
+
+      uninstall();
+      fd_ = fd;
+
+      // The first backtrace loads the unwinder, which allocates. Do it now rather than during a crash.
+      std::array<void*, max_frames> frames;
+      backtrace(frames.data(), static_cast<int>(frames.size()));
+
+      stack_t stack{};
+      stack.ss_sp = alternate_stack.data();
+      stack.ss_size = alternate_stack.size();
+      sigaltstack(&stack, nullptr);
+
+      struct sigaction action{};
+      action.sa_sigaction = &CrashHandler::handle_;
+      action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+      sigemptyset(&action.sa_mask);
+      for (size_t i = 0U; i < signals.size(); ++i)
+      {
+         sigaction(signals[i], &action, &previous_[i]);
+      }
+
+      return true;
+   }
+
+   void CrashHandler::uninstall()
+   {
+      int fd{ fd_.exchange(-1) };
+      if (fd < 0) return;
+
+      for (size_t i = 0U; i < signals.size(); ++i)
+      {
+         sigaction(signals[i], &previous_[i], nullptr);
+      }
+      ::close(fd);
+   }
+
+   void CrashHandler::handle_(int signal, siginfo_t* info, void* /*context*/)
+   {
+      int savedErrno{ errno };
+      int fd{ fd_.exchange(-1) };
+
+      // A crash inside the handler, or in another thread at the same time, finds no file and is not dumped twice.
+      size_t index{ static_cast<size_t>(std::find(signals.begin(), signals.end(), signal) - signals.begin()) };
+      if (fd >= 0)
+      {
+         FdOutput output{ fd };
+         cjm::fmt::write(output, "*** Crash: ");
+         cjm::fmt::write(output, index < signal_names.size() ? signal_names[index] : std::string_view("signal"));
+         cjm::fmt::write(output, " (");
+         cjm::fmt::writeNumber(output, signal);
+         cjm::fmt::write(output, ") at address ");
+         cjm::fmt::write(output, cjm::fmt::pointer_prefix);
+         cjm::fmt::writeNumber(output, reinterpret_cast<std::uintptr_t>(info->si_addr), 16);
+         cjm::fmt::write(output, " in thread ");
+         cjm::fmt::writeNumber(output, ::syscall(SYS_gettid));
+         cjm::fmt::write(output, " ***\n");
+
+         // Messages of each thread, merged across the levels in the order they were logged.
+         const Log*                 log{ Log::logger() };
+         const Log::RetentionShard* shard{ log != nullptr ? log->shardList_.load(std::memory_order_acquire) : nullptr };
+         for (; shard != nullptr; shard = shard->next)
+         {
+            cjm::fmt::write(output, "--- Thread ");
+            cjm::fmt::writeNumber(output, shard->thread);
+            cjm::fmt::write(output, " ---\n");
+
+            std::array<size_t, LogMsg::level_keys.size()> next{};
+            while (true)
+            {
+               size_t best{ next.size() };
+               for (size_t level = 0U; level < next.size(); ++level)
+               {
+                  const auto& messages{ shard->messages };
+                  if (next[level] < messages[level].size() &&
+                      (best == next.size() ||
+                       messages[level][next[level]].timestamp() < messages[best][next[best]].timestamp()))
+                  {
+                     best = level;
+                  }
+               }
+               if (best == next.size()) break;
+
+               writeMessage(output, shard->messages[best][next[best]]);
+               ++next[best];
+            }
+         }
+
+         cjm::fmt::write(output, "--- Backtrace ---\n");
+         output.flush();
+         std::array<void*, max_frames> frames;
+         backtrace_symbols_fd(frames.data(), backtrace(frames.data(), static_cast<int>(frames.size())), fd);
+         cjm::fmt::write(output, "*** End of crash dump ***\n");
+         output.flush();
+      }
+
+      // Let the previous handler, usually the default action, terminate the process once this one returns.
+      if (index < signals.size()) sigaction(signal, &previous_[index], nullptr);
+      errno = savedErrno;
+      raise(signal);
+   }
+} // namespace cjm::io
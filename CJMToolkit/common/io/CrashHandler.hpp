@@ -0,0 +1,82 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_CRASHHANDLER_HPP
+#define COMMON_IO_CRASHHANDLER_HPP
+
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <string_view>
+
+namespace cjm::io
+{
+   /**
+    * @brief Linux flight recorder that writes the retained logging messages when the process crashes.
+    * @details On SIGSEGV, SIGABRT, SIGBUS or SIGFPE, the handler writes the signal, the id of the crashing thread, the
+    *          messages retained by every thread and a raw backtrace to a file opened in advance. It only uses write(2)
+    *          and never locks or allocates, so it is safe to run in a signal handler. The rings are read while other
+    *          threads may still be logging, so their most recent messages can appear torn.
+    *          Afterwards, the previous handler of the signal is restored and the signal is raised again, so the
+    *          process still terminates and dumps core as it would without the handler.
+    */
+   class CrashHandler
+   {
+   public:
+      static constexpr std::array<int, 4> signals{ SIGSEGV, SIGABRT, SIGBUS, SIGFPE }; /**< Handled signals. */
+
+      static constexpr size_t max_frames{ 64U };           /**< Maximum depth of the backtrace. */
+      static constexpr size_t stack_size{ 64U * 1024U };   /**< Size of the alternate signal stack [B]. */
+      static constexpr size_t output_buffer_size{ 4096U }; /**< Bytes collected before each write. */
+
+      /**
+       * @brief Install the handler, replacing a previous installation.
+       * @details The file is opened now, in append mode, because a crashing process cannot open files safely. The
+       *          handler runs on an alternate stack of the calling thread, so that its stack overflows are reported
+       *          too; other threads run the handler on their own stack.
+       * @param fileName File of the crash dumps.
+       * @return true on success, false if the file cannot be opened.
+       */
+      static bool install(std::string_view fileName);
+
+      /**
+       * @brief Restore the previous signal handlers and close the file.
+       */
+      static void uninstall();
+
+   private:
+      /**
+       * @brief Signal handler.
+       * @param signal Received signal.
+       * @param info Details of the signal.
+       * @param context Context of the interrupted thread, unused.
+       */
+      static void handle_(int signal, siginfo_t* info, void* context);
+
+      static std::atomic<int>                             fd_;       /**< File of the crash dumps, -1 if none. */
+      static std::array<struct sigaction, signals.size()> previous_; /**< Handlers replaced by install. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_CRASHHANDLER_HPP
@@ -0,0 +1,394 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "FileSink.hpp"
+
+#include "common/data/BinaryLog.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace cjm::io
+{
+   using cjm::data::LogArchive;
+
+   namespace
+   {
+      constexpr std::chrono::seconds rotation_retry{ 1 }; /**< Delay before retrying a rotation that failed. */
+
+      /**
+       * @brief Get the name of a rotated file.
+       * @param fileName Path of the current file.
+       * @param generation Generation of the file, starting from 1.
+       * @param compressed If true, get the name of the compressed file.
+       * @return Path of the rotated file.
+       */
+      std::string generationName(const std::string& fileName, size_t generation, bool compressed)
+      {
+         std::string name{ fileName };
+         name += '.';
+         name += std::to_string(generation);
+         if (compressed) name += LogArchive::extension;
+         return name;
+      }
+
+      /**
+       * @brief Make room for a new first generation, removing the oldest one.
+       * @param fileName Path of the current file.
+       * @param generations Number of generations to keep.
+       */
+      void shiftGenerations(const std::string& fileName, size_t generations)
+      {
+         std::remove(generationName(fileName, generations, false).c_str());
+         std::remove(generationName(fileName, generations, true).c_str());
+         for (size_t generation = generations - 1U; generation > 0U; --generation)
+         {
+            std::rename(
+               generationName(fileName, generation, false).c_str(),
+               generationName(fileName, generation + 1U, false).c_str());
+            std::rename(
+               generationName(fileName, generation, true).c_str(),
+               generationName(fileName, generation + 1U, true).c_str());
+         }
+      }
+   } // namespace
+
+   /**
+    * @brief Worker thread that completes compressed rotations in order.
+    * @details A rotated file is renamed to a unique staging name and queued. For each job, the worker shifts the
+    *          generations, compresses the staged file next to it and renames the archive to the first generation, so
+    *          every rename of the rotated files happens on this thread.
+    */
+   class FileSink::Compressor
+   {
+   public:
+      /**
+       * @brief Constructor. Starts the worker thread.
+       */
+      Compressor() : thread_{ &Compressor::run_, this }
+      {
+      }
+
+      /**
+       * @brief Destructor. Completes the queued jobs and stops the worker thread.
+       */
+      ~Compressor()
+      {
+         {
+            std::scoped_lock lck{ mtx_ };
+            stopping_ = true;
+         }
+         cv_.notify_one();
+         thread_.join();
+      }
+
+      Compressor(const Compressor&) = delete;
+      Compressor& operator=(const Compressor&) = delete;
+
+      /**
+       * @brief Rename a file out of the way and queue its rotation.
+       * @param fileName Path of the file to rotate.
+       * @param generations Number of generations to keep.
+       * @param compress If true, compress the file.
+       * @param marks Block starts of the file, moved to the job if the file is renamed.
+       * @return true if the file was renamed, false if it is still in place.
+       */
+      bool rotate(const std::string& fileName, size_t generations, bool compress, std::vector<Mark>& marks)
+      {
+         std::unique_lock lck{ mtx_ };
+         std::string      staging{ fileName + ".rotating." + std::to_string(++staged_) };
+         if (std::rename(fileName.c_str(), staging.c_str()) != 0) return false;
+
+         jobs_.push_back(Job{ fileName, std::move(staging), generations, compress, std::move(marks) });
+         lck.unlock();
+         cv_.notify_one();
+         return true;
+      }
+
+   private:
+      /**
+       * @brief Rotation waiting for the worker.
+       */
+      struct Job
+      {
+         std::string       fileName;    /**< Path of the current file. */
+         std::string       staging;     /**< Path of the rotated file until it becomes the first generation. */
+         size_t            generations; /**< Number of generations to keep. */
+         bool              compress;    /**< true to compress the rotated file. */
+         std::vector<Mark> marks;       /**< Block starts of the rotated file. */
+      };
+
+      /**
+       * @brief Main loop of the worker thread.
+       */
+      void run_()
+      {
+         std::unique_lock lck{ mtx_ };
+         while (true)
+         {
+            cv_.wait(lck, [this]() { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) return;
+
+            Job job{ std::move(jobs_.front()) };
+            jobs_.pop_front();
+            lck.unlock();
+
+            // The uncompressed file is kept if the compression fails.
+            shiftGenerations(job.fileName, job.generations);
+            std::string archive{ job.staging + std::string(LogArchive::extension) };
+            if (job.compress && LogArchive::compress(job.staging, archive, job.marks))
+            {
+               std::remove(job.staging.c_str());
+               std::rename(archive.c_str(), generationName(job.fileName, 1U, true).c_str());
+            }
+            else
+            {
+               if (job.compress) std::remove(archive.c_str());
+               std::rename(job.staging.c_str(), generationName(job.fileName, 1U, false).c_str());
+            }
+
+            lck.lock();
+         }
+      }
+
+      std::mutex              mtx_;               /**< Mutex protecting the jobs. */
+      std::condition_variable cv_;                /**< Condition variable signalled when a job is queued. */
+      std::deque<Job>         jobs_;              /**< Rotations waiting for the worker. */
+      std::uint64_t           staged_{ 0U };      /**< Number of files staged so far, used for unique names. */
+      bool                    stopping_{ false }; /**< true once the worker must stop after the queued jobs. */
+      std::thread             thread_;            /**< Worker thread. */
+   };
+
+   FileSink::FileSink(std::string_view fileName, Encoding encoding) : fileName_{ fileName }, encoding_{ encoding }
+   {
+   }
+
+   FileSink::~FileSink()
+   {
+      file_.close();
+      durability_.close();
+      compressor_.reset();
+   }
+
+   FileSync::Policy FileSink::durability() const
+   {
+      return durability_.policy();
+   }
+
+   FileSink::Encoding FileSink::encoding() const
+   {
+      return encoding_;
+   }
+
+   const std::string& FileSink::fileName() const
+   {
+      return fileName_;
+   }
+
+   bool FileSink::init()
+   {
+      // Keep the file of a previous run as the first generation.
+      if (rotation_.generations > 0U)
+      {
+         std::ifstream previous(fileName_, std::ios::in | std::ios::binary | std::ios::ate);
+         if (previous.is_open() && previous.tellg() > 0)
+         {
+            previous.close();
+            return rotate_();
+         }
+      }
+
+      return open_(false);
+   }
+
+   bool FileSink::needsText() const
+   {
+      return encoding_ == Encoding::text;
+   }
+
+   std::string FileSink::rotatedName(size_t generation, bool compressed) const
+   {
+      return generationName(fileName_, generation, compressed);
+   }
+
+   const FileSink::Rotation& FileSink::rotation() const
+   {
+      return rotation_;
+   }
+
+   void FileSink::setDurability(FileSync::Policy policy, std::chrono::milliseconds interval)
+   {
+      durability_.setPolicy(policy, interval);
+   }
+
+   void FileSink::setRotation(const Rotation& rotation)
+   {
+      rotation_ = rotation;
+   }
+
+   FileSync::Latency FileSink::syncLatency() const
+   {
+      return durability_.latency();
+   }
+
+   void FileSink::takeOver(FileSink& other)
+   {
+      other.flush();
+      file_ = std::move(other.file_);
+      writtenFormats_ = other.writtenFormats_;
+      bytes_ = other.bytes_;
+      openedAt_ = other.openedAt_;
+      marks_ = std::move(other.marks_);
+      compressor_ = std::move(other.compressor_);
+
+      // The file is already open, failing to open it again only leaves it without syncs.
+      durability_.open(fileName_);
+   }
+
+   void FileSink::flush_()
+   {
+      file_.flush();
+      durability_.flushed();
+   }
+
+   void FileSink::write_(const LogMsg& message, std::string_view text)
+   {
+      if (rotationDue_() && !rotate_()) return;
+
+      // Let the archive start a block at this message, so that readers can seek to it.
+      if (rotation_.compress && (marks_.empty() || bytes_ - marks_.back().offset >= LogArchive::block_size))
+      {
+         marks_.push_back(Mark{ message.timestamp(), marks_.empty() ? 0U : bytes_ });
+
+         // Every block of a binary file defines again the texts it uses.
+         writtenFormats_ = 0U;
+      }
+
+      if (encoding_ == Encoding::text)
+      {
+         file_.write(text.data(), static_cast<std::streamsize>(text.size()));
+         bytes_ += text.size();
+      }
+      else
+      {
+         using cjm::data::BinaryLog;
+
+         // Define every text interned since the last message, so the file can be decoded on its own.
+         binaryBuffer_.clear();
+         for (std::uint32_t formatCount = BinaryLog::formatCount(); writtenFormats_ < formatCount; ++writtenFormats_)
+         {
+            BinaryLog::writeFormat(binaryBuffer_, writtenFormats_, BinaryLog::text(writtenFormats_));
+         }
+         BinaryLog::writeMessage(
+            binaryBuffer_,
+            static_cast<std::uint8_t>(message.level()),
+            message.timestamp(),
+            message.formatId(),
+            message.formatId() == BinaryLog::no_id ? message.message() : std::string_view(),
+            message.payload());
+         file_.write(binaryBuffer_.data(), static_cast<std::streamsize>(binaryBuffer_.size()));
+         bytes_ += binaryBuffer_.size();
+      }
+
+      // Errors are handed to the kernel at once and synced according to the durability policy.
+      if (message.level() >= LogMsg::Level::error && durability_.commitsErrors())
+      {
+         file_.flush();
+         durability_.commit(message.level() == LogMsg::Level::fatal);
+      }
+   }
+
+   bool FileSink::open_(bool append)
+   {
+      std::ios::openmode mode{ append ? std::ios::out | std::ios::app : std::ios::out };
+      if (encoding_ == Encoding::binary)
+      {
+         file_ = std::ofstream(fileName_, mode | std::ios::binary);
+         if (!append) file_ << cjm::data::BinaryLog::magic;
+      }
+      else
+      {
+         file_ = std::ofstream(fileName_, mode);
+      }
+      file_.seekp(0, std::ios::end);
+      bytes_ = static_cast<std::uint64_t>(std::max<std::streamoff>(file_.tellp(), 0));
+      writtenFormats_ = 0U;
+      openedAt_ = Clock::now();
+      marks_.clear();
+
+      return !file_.fail() && durability_.open(fileName_);
+   }
+
+   bool FileSink::rotate_()
+   {
+      // The file is renamed while it is still open, so that it can be written on if the rename fails.
+      file_.flush();
+
+      // Once a worker exists, it performs every shift, so that they are applied in the order of the rotations.
+      if (rotation_.compress && compressor_ == nullptr) compressor_ = std::make_unique<Compressor>();
+      bool renamed{ false };
+      if (compressor_ != nullptr)
+      {
+         renamed = compressor_->rotate(fileName_, rotation_.generations, rotation_.compress, marks_);
+      }
+      else
+      {
+         // The generations are only shifted once the file is out of the way, a failed rename leaves them untouched.
+         std::string staging{ fileName_ + ".rotating" };
+         renamed = std::rename(fileName_.c_str(), staging.c_str()) == 0;
+         if (renamed)
+         {
+            shiftGenerations(fileName_, rotation_.generations);
+            std::rename(staging.c_str(), rotatedName(1U, false).c_str());
+         }
+      }
+
+      // Truncating the file would lose it: keep appending to it and retry later.
+      if (!renamed)
+      {
+         retryAt_ = Clock::now() + rotation_retry;
+         return file_.is_open() || open_(true);
+      }
+
+      file_.close();
+      durability_.close();
+      return open_(false);
+   }
+
+   bool FileSink::rotationDue_() const
+   {
+      // An empty file is never rotated.
+      size_t headerSize{ encoding_ == Encoding::binary ? cjm::data::BinaryLog::magic.size() : 0U };
+      if (rotation_.generations == 0U || bytes_ <= headerSize) return false;
+      if (rotation_.maxSize > 0U && bytes_ >= rotation_.maxSize) return Clock::now() >= retryAt_;
+      if (rotation_.maxAge.count() <= 0) return false;
+
+      Clock::time_point now{ Clock::now() };
+      return now - openedAt_ >= rotation_.maxAge && now >= retryAt_;
+   }
+} // namespace cjm::io
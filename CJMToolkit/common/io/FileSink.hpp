@@ -0,0 +1,233 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_FILESINK_HPP
+#define COMMON_IO_FILESINK_HPP
+
+#include "FileSync.hpp"
+#include "LogSink.hpp"
+#include "common/data/LogArchive.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cjm::io
+{
+   /**
+    * @brief Sink that writes messages to a file, either as text or in the format of cjm::data::BinaryLog.
+    * @details The file can be rotated by size and by age. Rotated files are renamed <file>.1, <file>.2, ... up to the
+    *          number of generations to keep, and can be compressed into a cjm::data::LogArchive by a background worker,
+    *          which then also shifts the generations so that the writer never waits for a compression.
+    *          How the file reaches the disk is decided by its durability policy, see FileSync.
+    */
+   class FileSink : public LogSink
+   {
+   public:
+      /**
+       * @brief Encodings of the file.
+       */
+      enum class Encoding
+      {
+         text,  /**< Messages are formatted by the caller and written as text. */
+         binary /**< Messages keep their raw data and are written in the format of cjm::data::BinaryLog. */
+      };
+
+      /**
+       * @brief Rotation policy of the file.
+       */
+      struct Rotation
+      {
+         size_t               maxSize{ 0U };     /**< Size that triggers a rotation [B], 0 to disable. */
+         std::chrono::seconds maxAge{ 0 };       /**< Age that triggers a rotation, 0 to disable. */
+         size_t               generations{ 0U }; /**< Number of rotated files to keep, 0 to disable rotation. */
+         bool                 compress{ false }; /**< If true, rotated files are compressed. */
+      };
+
+      static constexpr std::string_view type{ "file" };            /**< Type of the sink in the settings. */
+      static constexpr size_t           mebibyte{ 1024U * 1024U }; /**< Unit of the maximum size in the settings. */
+
+      /**
+       * @brief Names of the settings nodes of file sinks.
+       */
+      struct Keys
+      {
+         static constexpr std::string_view file{ "File" };                  /**< Path of the file. */
+         static constexpr std::string_view encoding{ "Encoding" };          /**< Encoding of the file. */
+         static constexpr std::string_view text{ "text" };                  /**< Value of the text encoding. */
+         static constexpr std::string_view binary{ "binary" };              /**< Value of the binary encoding. */
+         static constexpr std::string_view max_size{ "MaxSize" };           /**< Size that triggers a rotation [MiB]. */
+         static constexpr std::string_view max_age{ "MaxAge" };             /**< Age that triggers a rotation [s]. */
+         static constexpr std::string_view generations{ "Generations" };    /**< Number of rotated files to keep. */
+         static constexpr std::string_view compress{ "Compress" };          /**< Compression of rotated files. */
+         static constexpr std::string_view enabled{ "true" };               /**< Value that enables compression. */
+         static constexpr std::string_view durability{ "Durability" };      /**< Durability policy. */
+         static constexpr std::string_view sync_interval{ "SyncInterval" }; /**< Period of periodic syncs [ms]. */
+         static constexpr std::string_view never{ "never" };                /**< Value of the never policy. */
+         static constexpr std::string_view periodic{ "periodic" };          /**< Value of the periodic policy. */
+         static constexpr std::string_view on_error{ "error" };             /**< Value of the on_error policy. */
+         static constexpr std::string_view group_commit{ "group" };         /**< Value of the group_commit policy. */
+      };
+
+      /**
+       * @brief Constructor.
+       * @param fileName Path of the file. It is truncated, or rotated, when the sink is initialised.
+       * @param encoding Encoding of the file.
+       */
+      FileSink(std::string_view fileName, Encoding encoding = Encoding::text);
+
+      /**
+       * @brief Destructor. Waits for the rotations still queued for compression.
+       */
+      ~FileSink() override;
+
+      /**
+       * @brief Get the durability policy of the file.
+       * @return Durability policy.
+       */
+      FileSync::Policy durability() const;
+
+      /**
+       * @brief Get the encoding of the file.
+       * @return Encoding of the file.
+       */
+      Encoding encoding() const;
+
+      /**
+       * @brief Get the path of the file.
+       * @return Path of the file.
+       */
+      const std::string& fileName() const;
+
+      /**
+       * @brief Open the file. When rotation is enabled, a previous non-empty file is rotated instead of truncated.
+       * @return true on success, false otherwise.
+       */
+      bool init();
+
+      /**
+       * @brief Check whether the sink uses the rendered text of the messages.
+       * @return true for text files, false for binary files.
+       */
+      bool needsText() const override;
+
+      /**
+       * @brief Get the name of a rotated file.
+       * @param generation Generation of the file, starting from 1.
+       * @param compressed If true, get the name of the compressed file.
+       * @return Path of the rotated file.
+       */
+      std::string rotatedName(size_t generation, bool compressed) const;
+
+      /**
+       * @brief Get the rotation policy of the file.
+       * @return Rotation policy.
+       */
+      const Rotation& rotation() const;
+
+      /**
+       * @brief Set the durability policy of the file. It must be set before the sink is initialised.
+       * @param policy Durability policy.
+       * @param interval Period of periodic syncs.
+       */
+      void setDurability(FileSync::Policy policy, std::chrono::milliseconds interval = FileSync::default_interval);
+
+      /**
+       * @brief Set the rotation policy of the file. It must be set before the sink is initialised.
+       * @param rotation Rotation policy.
+       */
+      void setRotation(const Rotation& rotation);
+
+      /**
+       * @brief Get the statistics of the syncs of the file so far. Can be called from any thread.
+       * @return Sync latency statistics.
+       */
+      FileSync::Latency syncLatency() const;
+
+      /**
+       * @brief Continue writing the file already opened by another sink, instead of truncating it.
+       * @param other Sink that writes the same file with the same encoding. Its file is closed.
+       */
+      void takeOver(FileSink& other);
+
+   protected:
+      /**
+       * @brief Flush the file.
+       */
+      void flush_() override;
+
+      /**
+       * @brief Write a message to the file.
+       * @param message Message to write.
+       * @param text Rendered message, terminated by a new line. Unused for binary files.
+       */
+      void write_(const LogMsg& message, std::string_view text) override;
+
+   private:
+      class Compressor;
+
+      /**
+       * @brief Open the file.
+       * @param append If true, append to the file instead of truncating it.
+       * @return true on success, false otherwise.
+       */
+      bool open_(bool append);
+
+      /**
+       * @brief Rotate the file and open a new one.
+       * @details Without compression, the older generations are shifted at once. With compression, the file is only
+       *          renamed out of the way and handed to the compression worker, which shifts the generations when its
+       *          turn comes. If the file cannot be renamed, it is kept and written on, and the rotation is retried a
+       *          second later.
+       * @return true on success, false if the new file could not be opened.
+       */
+      bool rotate_();
+
+      /**
+       * @brief Check whether the file must be rotated before writing another message.
+       * @return true or false.
+       */
+      bool rotationDue_() const;
+
+      using Mark = cjm::data::LogArchive::Mark;
+
+      std::string       fileName_;                   /**< Path of the file. */
+      Encoding          encoding_{ Encoding::text }; /**< Encoding of the file. */
+      std::ofstream     file_;                       /**< Output file. */
+      std::uint32_t     writtenFormats_{ 0U };       /**< Number of interned texts already defined in a binary file. */
+      std::string       binaryBuffer_;               /**< Buffer used to encode binary records. */
+      Rotation          rotation_;                   /**< Rotation policy. */
+      std::uint64_t     bytes_{ 0U };                /**< Bytes written to the current file. */
+      Clock::time_point openedAt_;                   /**< Time when the current file was opened. */
+      Clock::time_point retryAt_;                    /**< Earliest time of the next rotation after a failed one. */
+      std::vector<Mark> marks_;                      /**< Block starts of the current file. */
+      FileSync          durability_;                 /**< Durability policy of the current file. */
+
+      std::unique_ptr<Compressor> compressor_; /**< Worker completing compressed rotations, created on first use. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_FILESINK_HPP
@@ -0,0 +1,177 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "FileSync.hpp"
+
+#ifdef __linux__
+   #include <fcntl.h>
+   #include <unistd.h>
+#endif
+
+namespace cjm::io
+{
+   FileSync::~FileSync()
+   {
+      close();
+   }
+
+   void FileSync::close()
+   {
+      {
+         std::scoped_lock lck{ mtx_ };
+         running_ = false;
+      }
+      cv_.notify_all();
+      if (thread_.joinable()) thread_.join();
+
+      if (fd_ < 0) return;
+      if (policy_ != Policy::never) sync_(policy_ == Policy::group_commit);
+      synced_ = requested_;
+#ifdef __linux__
+      ::close(fd_);
+#endif
+      fd_ = -1;
+   }
+
+   void FileSync::commit(bool wait)
+   {
+      if (fd_ < 0 || !commitsErrors()) return;
+      requests_.fetch_add(1U, std::memory_order_relaxed);
+
+      if (policy_ == Policy::on_error)
+      {
+         sync_(false);
+         return;
+      }
+
+      std::unique_lock lck{ mtx_ };
+      std::uint64_t    ticket{ ++requested_ };
+      cv_.notify_all();
+      if (wait) cv_.wait(lck, [this, ticket]() { return synced_ >= ticket || !running_; });
+   }
+
+   bool FileSync::commitsErrors() const
+   {
+      return policy_ == Policy::on_error || policy_ == Policy::group_commit;
+   }
+
+   void FileSync::flushed()
+   {
+      if (policy_ == Policy::periodic) dirty_.store(true, std::memory_order_relaxed);
+   }
+
+   std::chrono::milliseconds FileSync::interval() const
+   {
+      return interval_;
+   }
+
+   FileSync::Latency FileSync::latency() const
+   {
+      Latency latency;
+      latency.count = syncs_.load(std::memory_order_relaxed);
+      latency.requests = requests_.load(std::memory_order_relaxed);
+      latency.totalNs = totalNs_.load(std::memory_order_relaxed);
+      latency.maxNs = maxNs_.load(std::memory_order_relaxed);
+      latency.errors = errors_.load(std::memory_order_relaxed);
+      return latency;
+   }
+
+   bool FileSync::open(const std::string& fileName)
+   {
+      close();
+      if (policy_ == Policy::never) return true;
+
+#ifdef __linux__
+      fd_ = ::open(fileName.c_str(), O_WRONLY | O_CLOEXEC);
+      if (fd_ < 0) return false;
+#else
+      static_cast<void>(fileName);
+      return true;
+#endif
+
+      if (policy_ == Policy::periodic || policy_ == Policy::group_commit)
+      {
+         running_ = true;
+         thread_ = std::thread(&FileSync::run_, this);
+      }
+      return true;
+   }
+
+   FileSync::Policy FileSync::policy() const
+   {
+      return policy_;
+   }
+
+   void FileSync::setPolicy(Policy policy, std::chrono::milliseconds interval)
+   {
+      policy_ = policy;
+      interval_ = interval.count() > 0 ? interval : default_interval;
+   }
+
+   void FileSync::run_()
+   {
+      std::unique_lock lck{ mtx_ };
+      while (running_)
+      {
+         if (policy_ == Policy::periodic)
+         {
+            cv_.wait_for(lck, interval_, [this]() { return !running_; });
+            if (!running_ || !dirty_.exchange(false, std::memory_order_relaxed)) continue;
+
+            lck.unlock();
+            sync_(false);
+            lck.lock();
+            continue;
+         }
+
+         cv_.wait(lck, [this]() { return !running_ || requested_ > synced_; });
+         if (requested_ == synced_) continue;
+
+         // Every request made up to now is covered by this sync, the ones arriving meanwhile wait for the next.
+         std::uint64_t target{ requested_ };
+         lck.unlock();
+         sync_(true);
+         lck.lock();
+         synced_ = target;
+         cv_.notify_all();
+      }
+   }
+
+   void FileSync::sync_(bool dataOnly)
+   {
+#ifdef __linux__
+      auto start{ std::chrono::steady_clock::now() };
+      int  result{ dataOnly ? ::fdatasync(fd_) : ::fsync(fd_) };
+      auto latency{ static_cast<std::uint64_t>(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()) };
+
+      syncs_.fetch_add(1U, std::memory_order_relaxed);
+      totalNs_.fetch_add(latency, std::memory_order_relaxed);
+      if (latency > maxNs_.load(std::memory_order_relaxed)) maxNs_.store(latency, std::memory_order_relaxed);
+      if (result != 0) errors_.fetch_add(1U, std::memory_order_relaxed);
+#else
+      static_cast<void>(dataOnly);
+#endif
+   }
+} // namespace cjm::io
@@ -0,0 +1,181 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_FILESYNC_HPP
+#define COMMON_IO_FILESYNC_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace cjm::io
+{
+   /**
+    * @brief Durability policy of a log file: decides when the data already written to the kernel is synced to disk.
+    * @details The file is synced through a descriptor of its own, so it works with any writer, such as a std::ofstream.
+    *          Only data already flushed by the writer is synced. Syncing is not available outside Linux, where every
+    *          policy behaves as never.
+    *          With group_commit, error messages hand a request to a background thread and return. Every request made
+    *          while a sync is running is served by the next one, so a burst of errors costs only a few fdatasync calls.
+    */
+   class FileSync
+   {
+   public:
+      /**
+       * @brief Available policies.
+       */
+      enum class Policy
+      {
+         never,       /**< The file is never synced. */
+         periodic,    /**< A background thread calls fsync every interval, if something was flushed. */
+         on_error,    /**< Every error or fatal message is followed by an fsync. */
+         group_commit /**< Error messages share the fdatasync calls of a background thread, fatal ones wait. */
+      };
+
+      /**
+       * @brief Statistics of the syncs performed so far.
+       */
+      struct Latency
+      {
+         std::uint64_t count{ 0U };    /**< Number of syncs. */
+         std::uint64_t requests{ 0U }; /**< Number of messages that asked for a sync. */
+         std::uint64_t totalNs{ 0U };  /**< Sum of all sync durations [ns]. */
+         std::uint64_t maxNs{ 0U };    /**< Longest sync [ns]. */
+         std::uint64_t errors{ 0U };   /**< Number of failed syncs. */
+      };
+
+      static constexpr std::chrono::milliseconds default_interval{ 1000 }; /**< Default period of periodic syncs. */
+
+      /**
+       * @brief Default constructor.
+       */
+      FileSync() = default;
+
+      /**
+       * @brief Copy constructor.
+       */
+      FileSync(const FileSync&) = delete;
+
+      /**
+       * @brief Destructor. Syncs the file one last time.
+       */
+      ~FileSync();
+
+      /**
+       * @brief Copy-assignment operator.
+       */
+      FileSync& operator=(const FileSync&) = delete;
+
+      /**
+       * @brief Sync the file and stop the background thread.
+       */
+      void close();
+
+      /**
+       * @brief Ask for the data flushed so far to be synced, according to the policy.
+       * @details With on_error the file is synced before returning. With group_commit the request is handed to the
+       *          background thread, and only waited for if wait is true.
+       * @param wait If true, return only after the data is on disk.
+       */
+      void commit(bool wait);
+
+      /**
+       * @brief Check whether error messages must be committed.
+       * @return true for on_error and group_commit, false otherwise.
+       */
+      bool commitsErrors() const;
+
+      /**
+       * @brief Notify that the writer flushed data to the kernel.
+       */
+      void flushed();
+
+      /**
+       * @brief Get the period of periodic syncs.
+       * @return Sync interval.
+       */
+      std::chrono::milliseconds interval() const;
+
+      /**
+       * @brief Get the statistics of the syncs so far. Can be called from any thread.
+       * @return Latency statistics.
+       */
+      Latency latency() const;
+
+      /**
+       * @brief Open a descriptor on the file and start the background thread needed by the policy.
+       * @param fileName Path of an existing file.
+       * @return true on success, false otherwise.
+       */
+      bool open(const std::string& fileName);
+
+      /**
+       * @brief Get the policy.
+       * @return Durability policy.
+       */
+      Policy policy() const;
+
+      /**
+       * @brief Set the policy. It must be set while the file is closed.
+       * @param policy Durability policy.
+       * @param interval Period of periodic syncs.
+       */
+      void setPolicy(Policy policy, std::chrono::milliseconds interval = default_interval);
+
+   private:
+      /**
+       * @brief Body of the background thread.
+       */
+      void run_();
+
+      /**
+       * @brief Sync the file and record the duration.
+       * @param dataOnly If true, use fdatasync instead of fsync.
+       */
+      void sync_(bool dataOnly);
+
+      Policy                    policy_{ Policy::never };      /**< Durability policy. */
+      std::chrono::milliseconds interval_{ default_interval }; /**< Period of periodic syncs. */
+      int                       fd_{ -1 };                     /**< Descriptor used to sync the file. */
+      std::thread               thread_;                       /**< Background thread. */
+      std::mutex                mtx_;                          /**< Mutex protecting the state of the thread. */
+      std::condition_variable   cv_;                           /**< Wakes the thread and the waiting writer. */
+      bool                      running_{ false };             /**< If true, the background thread must keep going. */
+      std::uint64_t             requested_{ 0U };              /**< Last group commit requested. */
+      std::uint64_t             synced_{ 0U };                 /**< Last group commit completed. */
+      std::atomic<bool>         dirty_{ false };               /**< If true, data was flushed since the last sync. */
+
+      std::atomic<std::uint64_t> syncs_{ 0U };    /**< Number of syncs. */
+      std::atomic<std::uint64_t> requests_{ 0U }; /**< Number of messages that asked for a sync. */
+      std::atomic<std::uint64_t> totalNs_{ 0U };  /**< Sum of all sync durations [ns]. */
+      std::atomic<std::uint64_t> maxNs_{ 0U };    /**< Longest sync [ns]. */
+      std::atomic<std::uint64_t> errors_{ 0U };   /**< Number of failed syncs. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_FILESYNC_HPP
@@ -0,0 +1,309 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "JsonSink.hpp"
+
+#include "common/data/BinaryLog.hpp"
+#include "common/format/Format.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__)
+   #include <immintrin.h>
+#endif
+
+namespace cjm::io
+{
+   namespace
+   {
+      constexpr std::string_view hex_digits{ "0123456789abcdef" }; /**< Digits of \u escapes. */
+      constexpr char             last_control{ 0x1F };              /**< Last control character. */
+
+      /**
+       * @brief Check whether a character must be escaped in a JSON string.
+       */
+      bool needsEscape(char character)
+      {
+         return character == '"' || character == '\\' || static_cast<unsigned char>(character) <= last_control;
+      }
+
+      /**
+       * @brief Append the escape sequence of a character.
+       */
+      void appendEscape(std::string& output, char character)
+      {
+         switch (character)
+         {
+         case '"':
+            output += "\\\"";
+            break;
+         case '\\':
+            output += "\\\\";
+            break;
+         case '\n':
+            output += "\\n";
+            break;
+         case '\r':
+            output += "\\r";
+            break;
+         case '\t':
+            output += "\\t";
+            break;
+         case '\b':
+            output += "\\b";
+            break;
+         case '\f':
+            output += "\\f";
+            break;
+         default:
+            output += "\\u00";
+            output += hex_digits[static_cast<unsigned char>(character) >> 4U];
+            output += hex_digits[static_cast<unsigned char>(character) & 0x0FU];
+            break;
+         }
+      }
+
+#if defined(__SSE2__)
+      /**
+       * @brief Escape the characters flagged in a block of text.
+       * @param output Destination of the JSON text.
+       * @param text Text being escaped.
+       * @param offset Position of the block in the text.
+       * @param mask Bit i is set if the character at offset + i must be escaped.
+       * @param begin First character not yet copied to the output, moved past the escaped characters.
+       */
+      void appendEscapes(std::string& output, std::string_view text, size_t offset, std::uint32_t mask, size_t& begin)
+      {
+         while (mask != 0U)
+         {
+            size_t position{ offset + static_cast<size_t>(__builtin_ctz(mask)) };
+            output.append(text.data() + begin, position - begin);
+            appendEscape(output, text[position]);
+            begin = position + 1U;
+            mask &= mask - 1U;
+         }
+      }
+#endif
+
+      /**
+       * @brief Check whether a text is a number in the JSON grammar.
+       */
+      bool jsonNumber(std::string_view text)
+      {
+         auto   digit = [&text](size_t i) { return i < text.size() && text[i] >= '0' && text[i] <= '9'; };
+         size_t i{ 0U };
+
+         if (i < text.size() && text[i] == '-') ++i;
+         if (!digit(i)) return false;
+         if (text[i] == '0')
+         {
+            ++i;
+         }
+         else
+         {
+            while (digit(i)) ++i;
+         }
+
+         if (i < text.size() && text[i] == '.')
+         {
+            if (!digit(++i)) return false;
+            while (digit(i)) ++i;
+         }
+
+         if (i < text.size() && (text[i] == 'e' || text[i] == 'E'))
+         {
+            ++i;
+            if (i < text.size() && (text[i] == '+' || text[i] == '-')) ++i;
+            if (!digit(i)) return false;
+            while (digit(i)) ++i;
+         }
+         return i == text.size();
+      }
+   } // namespace
+
+   JsonSink::JsonSink(std::string_view fileName, size_t bufferSize) : fileName_{ fileName }, bufferSize_{ bufferSize }
+   {
+      buffer_.reserve(bufferSize_);
+   }
+
+   JsonSink::~JsonSink()
+   {
+      writeBuffer_();
+   }
+
+   void JsonSink::appendString(std::string& output, std::string_view text)
+   {
+      output += '"';
+
+      size_t begin{ 0U };
+      size_t i{ 0U };
+#if defined(__AVX2__)
+      const __m256i quotes{ _mm256_set1_epi8('"') };
+      const __m256i backslashes{ _mm256_set1_epi8('\\') };
+      const __m256i controls{ _mm256_set1_epi8(last_control) };
+      for (; i + sizeof(__m256i) <= text.size(); i += sizeof(__m256i))
+      {
+         __m256i block{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i)) };
+
+         // A byte is a control character if the unsigned minimum with the last control character leaves it unchanged.
+         __m256i special{ _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quotes), _mm256_cmpeq_epi8(block, backslashes)),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(block, controls), block)) };
+         appendEscapes(output, text, i, static_cast<std::uint32_t>(_mm256_movemask_epi8(special)), begin);
+      }
+#endif
+#if defined(__SSE2__)
+      const __m128i quotes16{ _mm_set1_epi8('"') };
+      const __m128i backslashes16{ _mm_set1_epi8('\\') };
+      const __m128i controls16{ _mm_set1_epi8(last_control) };
+      for (; i + sizeof(__m128i) <= text.size(); i += sizeof(__m128i))
+      {
+         // Also handles the last 16 to 31 bytes left by the AVX2 loop.
+         __m128i block{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i)) };
+         __m128i special{ _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quotes16), _mm_cmpeq_epi8(block, backslashes16)),
+            _mm_cmpeq_epi8(_mm_min_epu8(block, controls16), block)) };
+         appendEscapes(output, text, i, static_cast<std::uint32_t>(_mm_movemask_epi8(special)), begin);
+      }
+#endif
+
+      // Remaining characters, or the whole text without SSE2.
+      for (; i < text.size(); ++i)
+      {
+         if (!needsEscape(text[i])) continue;
+
+         output.append(text.data() + begin, i - begin);
+         appendEscape(output, text[i]);
+         begin = i + 1U;
+      }
+      output.append(text.data() + begin, text.size() - begin);
+      output += '"';
+   }
+
+   size_t JsonSink::bufferSize() const
+   {
+      return bufferSize_;
+   }
+
+   const std::string& JsonSink::fileName() const
+   {
+      return fileName_;
+   }
+
+   bool JsonSink::init()
+   {
+      // The buffer of the sink replaces the one of the stream, so buffered messages are written in a single call.
+      file_.rdbuf()->pubsetbuf(nullptr, 0);
+      file_.open(fileName_, std::ios::out | std::ios::app | std::ios::binary);
+      return file_.is_open();
+   }
+
+   bool JsonSink::needsText() const
+   {
+      return false;
+   }
+
+   void JsonSink::flush_()
+   {
+      writeBuffer_();
+      file_.flush();
+   }
+
+   void JsonSink::write_(const LogMsg& message, std::string_view)
+   {
+      cjm::fmt::StringOutput output{ buffer_ };
+
+      buffer_ += "{\"";
+      buffer_ += Fields::level;
+      buffer_ += "\":\"";
+      buffer_ += LogMsg::level_names[static_cast<size_t>(message.level())];
+      buffer_ += "\",\"";
+      buffer_ += Fields::timestamp;
+      buffer_ += "\":";
+      cjm::fmt::writeNumber(output, message.timestamp());
+      buffer_ += ",\"";
+      buffer_ += Fields::message;
+      buffer_ += "\":";
+      appendString(buffer_, message.message());
+      buffer_ += ",\"";
+      buffer_ += Fields::data;
+      buffer_ += "\":{";
+
+      bool first{ true };
+      message.forEachField(
+         [this, &first](std::string_view description, cjm::data::BinaryLog::ArgType type, std::string_view value) {
+            if (!first) buffer_ += ',';
+            first = false;
+            appendString(buffer_, description);
+            buffer_ += ':';
+            appendValue_(type, value);
+         });
+      buffer_ += "}}\n";
+
+      if (buffer_.size() >= bufferSize_) writeBuffer_();
+   }
+
+   void JsonSink::appendValue_(cjm::data::BinaryLog::ArgType type, std::string_view value)
+   {
+      using ArgType = cjm::data::BinaryLog::ArgType;
+
+      switch (type)
+      {
+      case ArgType::boolean:
+      case ArgType::int8:
+      case ArgType::int16:
+      case ArgType::int32:
+      case ArgType::int64:
+      case ArgType::uint8:
+      case ArgType::uint16:
+      case ArgType::uint32:
+      case ArgType::uint64:
+         buffer_ += value;
+         return;
+      case ArgType::float32:
+      case ArgType::float64:
+         // NaN and infinities have no JSON representation, they are kept as strings.
+         if (jsonNumber(value))
+         {
+            buffer_ += value;
+            return;
+         }
+         break;
+      case ArgType::character:
+      case ArgType::level:
+      case ArgType::string:
+         break;
+      }
+
+      appendString(buffer_, value);
+   }
+
+   void JsonSink::writeBuffer_()
+   {
+      if (buffer_.empty()) return;
+
+      if (file_.is_open()) file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+      buffer_.clear();
+   }
+} // namespace cjm::io
@@ -0,0 +1,152 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_JSONSINK_HPP
+#define COMMON_IO_JSONSINK_HPP
+
+#include "LogSink.hpp"
+
+#include <fstream>
+#include <string>
+
+namespace cjm::io
+{
+   /**
+    * @brief Sink that writes messages to a file as newline-delimited JSON, one object per message.
+    * @details Every object holds the level, the timestamp [ns], the text and the data of the message, as in
+    *          {"level":"warn","timestamp":1250000,"message":"...","data":{"index":3,"file name":"a.txt"}}. Data that
+    *          was added as a number or a boolean is written as such, anything else as a string. Objects are built in a
+    *          reusable buffer that is written to the file when it is full or when the sink is flushed. The file is
+    *          appended to, so it can be collected across runs.
+    */
+   class JsonSink : public LogSink
+   {
+   public:
+      static constexpr std::string_view type{ "json" };    /**< Type of the sink in the settings. */
+      static constexpr size_t           kibibyte{ 1024U }; /**< Unit of the buffer size in the settings. */
+
+      /**
+       * @brief Default size of the output buffer [B].
+       */
+      static constexpr size_t default_buffer_size{ 1024U * kibibyte };
+
+      /**
+       * @brief Names of the settings nodes of JSON sinks.
+       */
+      struct Keys
+      {
+         static constexpr std::string_view file{ "File" };              /**< Path of the file. */
+         static constexpr std::string_view buffer_size{ "BufferSize" }; /**< Size of the output buffer [KiB]. */
+      };
+
+      /**
+       * @brief Names of the members of the JSON objects.
+       */
+      struct Fields
+      {
+         static constexpr std::string_view level{ "level" };         /**< Name of the level. */
+         static constexpr std::string_view timestamp{ "timestamp" }; /**< Timestamp of the message [ns]. */
+         static constexpr std::string_view message{ "message" };     /**< Text of the message. */
+         static constexpr std::string_view data{ "data" };           /**< Object with the data of the message. */
+      };
+
+      /**
+       * @brief Constructor.
+       * @param fileName Path of the file.
+       * @param bufferSize Size of the output buffer [B].
+       */
+      JsonSink(std::string_view fileName, size_t bufferSize = default_buffer_size);
+
+      /**
+       * @brief Destructor. Writes the buffered messages.
+       */
+      ~JsonSink() override;
+
+      /**
+       * @brief Append a text to a JSON document as a quoted string, escaping it.
+       * @details Quotes, backslashes and control characters are searched 16 bytes at a time with SSE2, or 32 bytes
+       *          with AVX2, so texts without any of them are copied in one piece.
+       * @param output Destination of the JSON text.
+       * @param text Text to append. Other bytes, including UTF-8 sequences, are copied unchanged.
+       */
+      static void appendString(std::string& output, std::string_view text);
+
+      /**
+       * @brief Get the size of the output buffer.
+       * @return Size of the output buffer [B].
+       */
+      size_t bufferSize() const;
+
+      /**
+       * @brief Get the path of the file.
+       * @return Path of the file.
+       */
+      const std::string& fileName() const;
+
+      /**
+       * @brief Open the file for appending.
+       * @return true on success, false otherwise.
+       */
+      bool init();
+
+      /**
+       * @brief Check whether the sink uses the rendered text of the messages.
+       * @return false, messages are converted from their data.
+       */
+      bool needsText() const override;
+
+   protected:
+      /**
+       * @brief Write the buffered messages to the file.
+       */
+      void flush_() override;
+
+      /**
+       * @brief Append a message to the buffer, writing the buffer to the file when it is full.
+       * @param message Message to write.
+       * @param text Unused.
+       */
+      void write_(const LogMsg& message, std::string_view text) override;
+
+   private:
+      /**
+       * @brief Append a datagram value, unquoted if it was added as a number or a boolean.
+       * @param type Type of the value when it was added to the message.
+       * @param value Value of the datagram.
+       */
+      void appendValue_(cjm::data::BinaryLog::ArgType type, std::string_view value);
+
+      /**
+       * @brief Write the buffer to the file and empty it, keeping its capacity.
+       */
+      void writeBuffer_();
+
+      std::string   fileName_;   /**< Path of the file. */
+      size_t        bufferSize_; /**< Size of the output buffer [B]. */
+      std::string   buffer_;     /**< Output buffer. */
+      std::ofstream file_;       /**< Output file. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_JSONSINK_HPP
@@ -24,16 +24,553 @@
 
 #include "Log.hpp"
 
+#include "ConsoleSink.hpp"
+#include "JsonSink.hpp"
+#include "MemorySink.hpp"
+#include "common/data/BaseSettings.hpp"
+
+#ifdef __linux__
+   #include "CrashHandler.hpp"
+   #include "MmapFileSink.hpp"
+   #include "ShmSink.hpp"
+   #include "UringFileSink.hpp"
+
+   #include <sys/syscall.h>
+   #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
 namespace cjm::io
 {
    using cjm::data::LogMsg;
+   using namespace cjm::data::log_literals;
+
+   namespace
+   {
+      /**
+       * @brief Read an optional non-negative number from the settings.
+       * @param settings Settings of a sink.
+       * @param key Name of the node.
+       * @param value Value of the node, unchanged if the node is missing.
+       * @return true if the node is missing or valid, false otherwise.
+       */
+      bool readCount(const cjm::data::BaseSettings& settings, std::string_view key, long& value)
+      {
+         cjm::data::BaseSettings node{ settings.enterNode(key) };
+         if (!node.valid()) return true;
+
+         value = std::atol(std::string(node.value()).c_str());
+         return value >= 0;
+      }
+   } // namespace
 
    /********** STATIC VARIABLES DEFINITIONS **********/
-   bool                 Log::initialised_{ false };
-   std::unique_ptr<Log> Log::logger_;
+   bool                       Log::initialised_{ false };
+   std::unique_ptr<Log>       Log::logger_;
+   std::atomic<std::uint64_t> Log::instances_{ 0U };
 
    /********** METHOD DEFINITIONS **********/
-   bool Log::init(std::string_view logFile)
+   Log::~Log()
+   {
+      stopWriter_();
+      flush();
+   }
+
+   void Log::addSink(std::unique_ptr<LogSink> sink)
+   {
+      if (sink == nullptr) return;
+
+      std::scoped_lock lck{ ioMtx_ };
+      sinks_.emplace_back(std::move(sink));
+      updateEncoding_();
+   }
+
+   bool Log::configure(const cjm::data::BaseSettings& settings)
+   {
+      using cjm::data::BaseSettings;
+
+      if (!settings.valid())
+      {
+         error("Invalid logging settings."_lt);
+         return false;
+      }
+
+      // Behaviour of the full asynchronous queue, applied together with the sinks.
+      Backpressure              backpressure{ backpressure_.load() };
+      std::chrono::milliseconds queueTimeout{ queueTimeout_.load() };
+      LogMsg::Level             dropLevel{ dropLevel_.load() };
+      BaseSettings              queueSettings{ settings.enterNode(Keys::queue) };
+      if (queueSettings.valid())
+      {
+         BaseSettings policySettings{ queueSettings.enterNode(Keys::backpressure) };
+         if (policySettings.valid())
+         {
+            std::string_view value{ policySettings.value() };
+            if (value == Keys::block)
+            {
+               backpressure = Backpressure::block;
+            }
+            else if (value == Keys::drop_newest)
+            {
+               backpressure = Backpressure::drop_newest;
+            }
+            else if (value == Keys::drop_oldest)
+            {
+               backpressure = Backpressure::drop_oldest;
+            }
+            else if (value == Keys::drop_below)
+            {
+               backpressure = Backpressure::drop_below;
+            }
+            else
+            {
+               error("Invalid queue backpressure policy."_lt, pack("policy"_lt, value));
+               return false;
+            }
+         }
+
+         long timeout{ queueTimeout.count() };
+         if (!readCount(queueSettings, Keys::timeout, timeout))
+         {
+            error("Invalid queue timeout."_lt, pack("timeout"_lt, queueSettings.enterNode(Keys::timeout).value()));
+            return false;
+         }
+         queueTimeout = std::chrono::milliseconds(timeout);
+
+         BaseSettings levelSettings{ queueSettings.enterNode(Keys::drop_level) };
+         if (levelSettings.valid() && !LogMsg::parseLevel(levelSettings.value(), dropLevel))
+         {
+            error("Invalid queue drop level."_lt, pack("level"_lt, levelSettings.value()));
+            return false;
+         }
+      }
+
+      // Rate limit of repeated messages, applied together with the sinks.
+      long         rate{ static_cast<long>(limiter_.rate()) };
+      long         burst{ static_cast<long>(limiter_.burst()) };
+      BaseSettings rateSettings{ settings.enterNode(Keys::rate_limit) };
+      if (rateSettings.valid() &&
+          (!readCount(rateSettings, Keys::rate, rate) || !readCount(rateSettings, Keys::burst, burst)))
+      {
+         error("Invalid rate limit of repeated messages."_lt);
+         return false;
+      }
+
+      // Sampling rates of the levels and of the call sites, applied together with the sinks.
+      std::array<long, LogMsg::level_keys.size()>    levelSampling;
+      std::vector<std::pair<std::string_view, long>> siteSampling;
+      BaseSettings                                   samplingSettings{ settings.enterNode(Keys::sampling) };
+      for (size_t level = 0U; level < levelSampling.size(); ++level)
+      {
+         levelSampling[level] = static_cast<long>(sampling_[level].load(std::memory_order_relaxed));
+         if (samplingSettings.valid() && !readCount(samplingSettings, LogMsg::level_names[level], levelSampling[level]))
+         {
+            error("Invalid sampling rate."_lt, pack("level"_lt, LogMsg::level_names[level]));
+            return false;
+         }
+      }
+      for (long i = 0; samplingSettings.valid(); ++i)
+      {
+         BaseSettings siteSettings{ samplingSettings.enterNode(Keys::site, i) };
+         if (!siteSettings.valid()) break;
+
+         std::string_view pattern{ siteSettings.attribute(Keys::pattern) };
+         long             siteRate{ std::atol(std::string(siteSettings.value()).c_str()) };
+         if (pattern.empty() || siteRate < 0)
+         {
+            error(
+               "Invalid sampling rate of call sites."_lt,
+               pack("pattern"_lt, pattern),
+               pack("rate"_lt, siteSettings.value()));
+            return false;
+         }
+         siteSampling.emplace_back(pattern, siteRate);
+      }
+
+      // Levels of the categories, applied together with the sinks.
+      std::vector<std::pair<std::string_view, LogMsg::Level>> categoryLevels;
+      for (long i = 0;; ++i)
+      {
+         BaseSettings categorySettings{ settings.enterNode(Keys::category, i) };
+         if (!categorySettings.valid()) break;
+
+         LogMsg::Level level{ LogMsg::Level::trace };
+         if (!LogMsg::parseLevel(categorySettings.value(), level))
+         {
+            error(
+               "Invalid category level."_lt,
+               pack("category"_lt, categorySettings.attribute(Keys::name)),
+               pack("level"_lt, categorySettings.value()));
+            return false;
+         }
+         categoryLevels.emplace_back(categorySettings.attribute(Keys::name), level);
+      }
+
+      // Context written before errors, applied together with the sinks.
+      ErrorContext errorContext{ this->errorContext() };
+      BaseSettings contextSettings{ settings.enterNode(Keys::error_context) };
+      if (contextSettings.valid())
+      {
+         long             size{ std::atol(std::string(contextSettings.value()).c_str()) };
+         std::string_view threads{ contextSettings.attribute(Keys::threads) };
+         if (size < 0 || (!threads.empty() && threads != Keys::all_threads && threads != Keys::same_thread))
+         {
+            error("Invalid error context."_lt, pack("size"_lt, contextSettings.value()), pack("threads"_lt, threads));
+            return false;
+         }
+         errorContext.size = static_cast<size_t>(size);
+         errorContext.allThreads = threads == Keys::all_threads;
+      }
+
+      // Filter of the recorded messages, applied together with the sinks.
+      std::string  filter{ this->filter() };
+      BaseSettings filterSettings{ settings.enterNode(Keys::filter) };
+      if (filterSettings.valid())
+      {
+         LogFilter compiled;
+         if (!compiled.compile(filterSettings.value()))
+         {
+            error(
+               "Invalid filter."_lt,
+               pack("filter"_lt, filterSettings.value()),
+               pack("error offset"_lt, compiled.errorOffset()));
+            return false;
+         }
+         filter = filterSettings.value();
+      }
+
+      // Date and time of text messages, applied together with the sinks.
+      bool         wallClock{ this->wallClock() };
+      BaseSettings wallClockSettings{ settings.enterNode(Keys::wall_clock) };
+      if (wallClockSettings.valid()) wallClock = wallClockSettings.value() == Keys::enabled;
+
+#ifdef __linux__
+      // File of the crash dumps, opened together with the sinks.
+      BaseSettings     crashSettings{ settings.enterNode(Keys::crash_dump) };
+      std::string_view crashDump{ crashSettings.valid() ? crashSettings.value() : std::string_view() };
+#endif
+
+      // Build every sink before touching the current ones, which keep logging any configuration error.
+      std::vector<std::unique_ptr<LogSink>> sinks;
+      for (long i = 0;; ++i)
+      {
+         BaseSettings sinkSettings{ settings.enterNode(Keys::sink, i) };
+         if (!sinkSettings.valid()) break;
+
+         std::string_view type{ sinkSettings.attribute(Keys::type) };
+
+         std::unique_ptr<LogSink> sink;
+         if (type == ConsoleSink::type)
+         {
+            sink = std::make_unique<ConsoleSink>();
+         }
+         else if (type == FileSink::type)
+         {
+            BaseSettings fileSettings{ sinkSettings.enterNode(FileSink::Keys::file) };
+            if (!fileSettings.valid())
+            {
+               error("No file specified for a file sink."_lt, pack("missing node"_lt, FileSink::Keys::file));
+               return false;
+            }
+
+            Encoding     encoding{ Encoding::text };
+            BaseSettings encodingSettings{ sinkSettings.enterNode(FileSink::Keys::encoding) };
+            if (encodingSettings.valid())
+            {
+               if (encodingSettings.value() == FileSink::Keys::binary)
+               {
+                  encoding = Encoding::binary;
+               }
+               else if (encodingSettings.value() != FileSink::Keys::text)
+               {
+                  error("Invalid file sink encoding."_lt, pack("encoding"_lt, encodingSettings.value()));
+                  return false;
+               }
+            }
+
+            long maxSize{ 0 };
+            long maxAge{ 0 };
+            long generations{ 0 };
+            if (!readCount(sinkSettings, FileSink::Keys::max_size, maxSize) ||
+                !readCount(sinkSettings, FileSink::Keys::max_age, maxAge) ||
+                !readCount(sinkSettings, FileSink::Keys::generations, generations))
+            {
+               error("Invalid file sink rotation."_lt, pack("file name"_lt, fileSettings.value()));
+               return false;
+            }
+
+            FileSink::Rotation rotation;
+            rotation.maxSize = static_cast<size_t>(maxSize) * FileSink::mebibyte;
+            rotation.maxAge = std::chrono::seconds(maxAge);
+            rotation.generations = static_cast<size_t>(generations);
+            BaseSettings compressSettings{ sinkSettings.enterNode(FileSink::Keys::compress) };
+            rotation.compress = compressSettings.valid() && compressSettings.value() == FileSink::Keys::enabled;
+
+            FileSync::Policy durability{ FileSync::Policy::never };
+            BaseSettings     durabilitySettings{ sinkSettings.enterNode(FileSink::Keys::durability) };
+            if (durabilitySettings.valid())
+            {
+               std::string_view value{ durabilitySettings.value() };
+               if (value == FileSink::Keys::periodic)
+               {
+                  durability = FileSync::Policy::periodic;
+               }
+               else if (value == FileSink::Keys::on_error)
+               {
+                  durability = FileSync::Policy::on_error;
+               }
+               else if (value == FileSink::Keys::group_commit)
+               {
+                  durability = FileSync::Policy::group_commit;
+               }
+               else if (value != FileSink::Keys::never)
+               {
+                  error("Invalid file sink durability."_lt, pack("durability"_lt, value));
+                  return false;
+               }
+            }
+            long syncInterval{ FileSync::default_interval.count() };
+            if (!readCount(sinkSettings, FileSink::Keys::sync_interval, syncInterval) || syncInterval == 0)
+            {
+               error("Invalid file sink sync interval."_lt, pack("file name"_lt, fileSettings.value()));
+               return false;
+            }
+
+            // Files are opened when the sinks are swapped, so that a file already in use is not truncated.
+            auto fileSink{ std::make_unique<FileSink>(fileSettings.value(), encoding) };
+            fileSink->setRotation(rotation);
+            fileSink->setDurability(durability, std::chrono::milliseconds(syncInterval));
+            sink = std::move(fileSink);
+         }
+         else if (type == JsonSink::type)
+         {
+            BaseSettings fileSettings{ sinkSettings.enterNode(JsonSink::Keys::file) };
+            if (!fileSettings.valid())
+            {
+               error("No file specified for a JSON sink."_lt, pack("missing node"_lt, JsonSink::Keys::file));
+               return false;
+            }
+
+            long bufferSize{ static_cast<long>(JsonSink::default_buffer_size / JsonSink::kibibyte) };
+            if (!readCount(sinkSettings, JsonSink::Keys::buffer_size, bufferSize))
+            {
+               error("Invalid JSON sink buffer size."_lt, pack("file name"_lt, fileSettings.value()));
+               return false;
+            }
+
+            // The file is opened with the other outputs, once every sink is valid.
+            sink = std::make_unique<JsonSink>(
+               fileSettings.value(), static_cast<size_t>(bufferSize) * JsonSink::kibibyte);
+         }
+#ifdef __linux__
+         else if (type == UringFileSink::type)
+         {
+            BaseSettings fileSettings{ sinkSettings.enterNode(UringFileSink::Keys::file) };
+            if (!fileSettings.valid())
+            {
+               error("No file specified for an io_uring sink."_lt, pack("missing node"_lt, UringFileSink::Keys::file));
+               return false;
+            }
+
+            // The file is opened with the other outputs, once every sink is valid.
+            sink = std::make_unique<UringFileSink>(fileSettings.value());
+         }
+         else if (type == MmapFileSink::type)
+         {
+            BaseSettings fileSettings{ sinkSettings.enterNode(MmapFileSink::Keys::file) };
+            if (!fileSettings.valid())
+            {
+               error(
+                  "No file specified for a memory-mapped sink."_lt, pack("missing node"_lt, MmapFileSink::Keys::file));
+               return false;
+            }
+
+            size_t       segmentSize{ MmapFileSink::default_segment_size };
+            BaseSettings sizeSettings{ sinkSettings.enterNode(MmapFileSink::Keys::segment_size) };
+            if (sizeSettings.valid())
+            {
+               long value{ std::atol(std::string(sizeSettings.value()).c_str()) };
+               if (value <= 0)
+               {
+                  error("Invalid segment size."_lt, pack("segment size [MiB]"_lt, sizeSettings.value()));
+                  return false;
+               }
+               segmentSize = static_cast<size_t>(value) * MmapFileSink::mebibyte;
+            }
+
+            // The first segment is mapped with the other outputs, once every sink is valid.
+            sink = std::make_unique<MmapFileSink>(fileSettings.value(), segmentSize);
+         }
+         else if (type == ShmSink::type)
+         {
+            BaseSettings nameSettings{ sinkSettings.enterNode(ShmSink::Keys::name) };
+            if (!nameSettings.valid())
+            {
+               error("No name specified for a shared-memory sink."_lt, pack("missing node"_lt, ShmSink::Keys::name));
+               return false;
+            }
+
+            long slots{ static_cast<long>(ShmRing::default_slots) };
+            long slotSize{ static_cast<long>(ShmRing::default_slot_size) };
+            if (!readCount(sinkSettings, ShmSink::Keys::slots, slots) ||
+                !readCount(sinkSettings, ShmSink::Keys::slot_size, slotSize) || slots == 0)
+            {
+               error("Invalid shared-memory ring size."_lt, pack("name"_lt, nameSettings.value()));
+               return false;
+            }
+
+            // The ring is created with the other outputs, once every sink is valid.
+            sink = std::make_unique<ShmSink>(
+               nameSettings.value(), static_cast<size_t>(slots), static_cast<size_t>(slotSize));
+         }
+#endif
+         else if (type == MemorySink::type)
+         {
+            size_t       capacity{ MemorySink::default_capacity };
+            BaseSettings capacitySettings{ sinkSettings.enterNode(MemorySink::Keys::capacity) };
+            if (capacitySettings.valid())
+            {
+               long value{ std::atol(std::string(capacitySettings.value()).c_str()) };
+               if (value <= 0)
+               {
+                  error("Invalid memory sink capacity."_lt, pack("capacity"_lt, capacitySettings.value()));
+                  return false;
+               }
+               capacity = static_cast<size_t>(value);
+            }
+            sink = std::make_unique<MemorySink>(capacity);
+         }
+         else
+         {
+            error("Unknown sink type."_lt, pack("sink index"_lt, i), pack("type"_lt, type));
+            return false;
+         }
+
+         if (!sink->configure(sinkSettings)) return false;
+         sinks.emplace_back(std::move(sink));
+      }
+
+      // Open the new outputs. An output already written by a current sink is taken over instead, so that it is not
+      // truncated.
+      LogText                  failure;
+      std::string              failedOutput;
+      std::vector<std::string> fallbacks;
+      size_t                   sinkCount{ sinks.size() };
+      {
+         std::scoped_lock                   lck{ ioMtx_ };
+         std::vector<std::function<void()>> takeOvers;
+         for (auto& sink : sinks)
+         {
+            if (!openSink_(*sink, takeOvers, failure, failedOutput)) break;
+         }
+
+#ifdef __linux__
+         // The crash dump file is opened now, a crash cannot open files safely.
+         if (failedOutput.empty() && !crashDump.empty() && !CrashHandler::install(crashDump))
+         {
+            failure = "Failed to open the crash dump file."_lt;
+            failedOutput = crashDump;
+         }
+#endif
+
+         if (failedOutput.empty())
+         {
+            for (auto& takeOver : takeOvers)
+            {
+               takeOver();
+            }
+            for (auto& sink : sinks_)
+            {
+               sink->flush();
+            }
+            sinks_ = std::move(sinks);
+            updateEncoding_();
+
+#ifdef __linux__
+            for (auto& sink : sinks_)
+            {
+               auto uringSink{ dynamic_cast<UringFileSink*>(sink.get()) };
+               if (uringSink != nullptr && !uringSink->usingUring()) fallbacks.emplace_back(uringSink->fileName());
+            }
+#endif
+         }
+      }
+
+      if (!failedOutput.empty())
+      {
+         error(failure, pack("file name"_lt, failedOutput));
+         return false;
+      }
+      for (const auto& fileName : fallbacks)
+      {
+         CJM_LOG_WARN(this, "io_uring not available, using pwritev.", pack("file name"_lt, fileName));
+      }
+
+      setBackpressure(backpressure, queueTimeout, dropLevel);
+      setRateLimit(static_cast<std::uint32_t>(rate), static_cast<std::uint32_t>(burst));
+      setErrorContext(errorContext);
+      setWallClock(wallClock);
+      // A replaced filter stays allocated as long as the logger, so it is only replaced if the expression changed.
+      if (filter != this->filter()) setFilter(filter);
+      for (size_t level = 0U; level < levelSampling.size(); ++level)
+      {
+         setSampling(static_cast<LogMsg::Level>(level), static_cast<std::uint32_t>(levelSampling[level]));
+      }
+      // Rules of a previous configuration do not outlive it.
+      LogSite::clearSampling();
+      for (const auto& [pattern, siteRate] : siteSampling)
+      {
+         LogSite::setSampling(pattern, static_cast<std::uint32_t>(siteRate));
+      }
+      for (const auto& [name, level] : categoryLevels)
+      {
+         LogCategory::setLevel(name, level);
+      }
+      CJM_LOG_INFO(this, "Logging sinks configured.", pack("number of sinks"_lt, sinkCount));
+      return true;
+   }
+
+   std::uint64_t Log::dropped(LogMsg::Level level) const
+   {
+      return dropped_[static_cast<size_t>(level)].load(std::memory_order_relaxed);
+   }
+
+   Log::ErrorContext Log::errorContext() const
+   {
+      ErrorContext context;
+      context.size = contextSize_.load(std::memory_order_relaxed);
+      context.allThreads = contextAllThreads_.load(std::memory_order_relaxed);
+      return context;
+   }
+
+   bool Log::wallClock() const
+   {
+      return wallClock_.load(std::memory_order_relaxed);
+   }
+
+   std::string Log::filter() const
+   {
+      std::scoped_lock lck{ filtersMtx_ };
+      const LogFilter* filter{ filter_.load(std::memory_order_relaxed) };
+      return filter != nullptr ? filter->expression() : std::string();
+   }
+
+   void Log::flush()
+   {
+      std::scoped_lock lck{ ioMtx_ };
+
+      // Pending repeats are summarised now: the process may exit before their quiet period ends.
+      sweepRepeats_(true);
+      for (auto& sink : sinks_)
+      {
+         sink->flush();
+      }
+   }
+
+   bool Log::init(std::string_view logFile, Mode mode, Encoding encoding)
    {
       if (!initialised_)
       {
@@ -48,12 +585,20 @@ namespace cjm::io
          std::ios_base::sync_with_stdio(false);
 
          // Initialise the logger.
-         logger_->outputFile_ = std::ofstream(logFile.data());
-         if (logger_->outputFile_.fail())
+         auto               fileSink{ std::make_unique<FileSink>(logFile, encoding) };
+         FileSink::Rotation rotation;
+         rotation.generations = default_generations;
+         fileSink->setRotation(rotation);
+         if (!fileSink->init())
          {
             return false;
          }
-         logger_->startTime_ = std::chrono::steady_clock::now();
+         logger_->addSink(std::make_unique<ConsoleSink>());
+         logger_->addSink(std::move(fileSink));
+         LogClock::calibrate();
+         logger_->startTime_ = LogClock::now();
+
+         if (mode == Mode::async) logger_->startWriter_();
 
          initialised_ = true;
       }
@@ -71,9 +616,587 @@ namespace cjm::io
       return logger_.get();
    }
 
+   Log::Mode Log::mode() const
+   {
+      return mode_;
+   }
+
+   void Log::setBackpressure(Backpressure policy, std::chrono::milliseconds timeout, LogMsg::Level dropLevel)
+   {
+      backpressure_ = policy;
+      queueTimeout_ = timeout;
+      dropLevel_ = dropLevel;
+   }
+
+   void Log::setErrorContext(const ErrorContext& context)
+   {
+      contextAllThreads_.store(context.allThreads, std::memory_order_relaxed);
+      contextSize_.store(context.size, std::memory_order_relaxed);
+   }
+
+   void Log::setWallClock(bool enabled)
+   {
+      wallClock_.store(enabled, std::memory_order_relaxed);
+   }
+
+   bool Log::setFilter(std::string_view expression)
+   {
+      auto filter{ std::make_unique<LogFilter>() };
+      if (!filter->compile(expression)) return false;
+
+      std::scoped_lock lck{ filtersMtx_ };
+      if (filter->empty())
+      {
+         filter_.store(nullptr, std::memory_order_release);
+         return true;
+      }
+      filters_.emplace_back(std::move(filter));
+      filter_.store(filters_.back().get(), std::memory_order_release);
+      return true;
+   }
+
+   void Log::setRateLimit(std::uint32_t rate, std::uint32_t burst)
+   {
+      limiter_.setRate(rate, burst);
+   }
+
+   void Log::setSampling(LogMsg::Level level, std::uint32_t sampling)
+   {
+      sampling_[static_cast<size_t>(level)].store(sampling, std::memory_order_relaxed);
+   }
+
    void Log::setLevel(LogMsg::Level level)
    {
       logLevel_ = level;
-      trace("Log level set.", pack("log level", logLevel_.load()));
+      trace("Log level set."_lt, pack("log level"_lt, logLevel_.load()));
+   }
+
+   std::vector<LogMsg> Log::snapshot(LogMsg::Level minLevel) const
+   {
+      std::vector<std::shared_ptr<RetentionShard>> shards;
+      {
+         std::scoped_lock lck{ shardPool_->mtx };
+         shards = shardPool_->shards;
+      }
+
+      std::vector<LogMsg> messages;
+      for (const auto& shard : shards)
+      {
+         std::scoped_lock lck{ shard->mtx };
+         for (size_t level = static_cast<size_t>(minLevel); level < shard->messages.size(); ++level)
+         {
+            const auto& queue{ shard->messages[level] };
+            for (size_t i = 0U; i < queue.size(); ++i)
+            {
+               messages.emplace_back(queue[i]);
+            }
+         }
+      }
+
+      // Every ring is already sorted, a stable sort keeps the order of messages with the same timestamp.
+      std::stable_sort(messages.begin(), messages.end(), [](const LogMsg& lhs, const LogMsg& rhs) {
+         return lhs.timestamp() < rhs.timestamp();
+      });
+
+      return messages;
+   }
+
+   void Log::shutdown()
+   {
+      if (logger_ != nullptr) logger_->stopWriter_();
+   }
+
+   void Log::enqueue_(const LogMsg& message, Delivery delivery)
+   {
+      // Message evicted by drop_oldest, kept to reuse its memory.
+      thread_local LogMsg evictedMessage;
+
+      // Errors are never dropped: when the queue has no room for them, they are written directly.
+      auto drop = [this](const LogMsg& dropped) {
+         if (dropped.level() >= LogMsg::Level::error)
+         {
+            std::scoped_lock lck{ ioMtx_ };
+            write_(dropped);
+            return;
+         }
+         dropped_[static_cast<size_t>(dropped.level())].fetch_add(1U, std::memory_order_relaxed);
+      };
+
+      std::chrono::steady_clock::time_point deadline;
+      bool                                  waiting{ false };
+      while (!asyncQueue_->tryPush(message))
+      {
+         // The writer is gone: nobody will ever make room in the queue.
+         if (!writerRunning_.load(std::memory_order_acquire))
+         {
+            std::scoped_lock lck{ ioMtx_ };
+            write_(message);
+            return;
+         }
+
+         Backpressure policy{ backpressure_.load(std::memory_order_relaxed) };
+         if (delivery == Delivery::no_wait || policy == Backpressure::drop_newest ||
+             (policy == Backpressure::drop_below && message.level() < dropLevel_.load(std::memory_order_relaxed)))
+         {
+            drop(message);
+            return;
+         }
+         if (policy == Backpressure::drop_oldest)
+         {
+            if (asyncQueue_->tryPop(evictedMessage)) drop(evictedMessage);
+            continue;
+         }
+
+         // The queue is full: sleep until the writer makes room, but not forever.
+         std::chrono::milliseconds timeout{ queueTimeout_.load(std::memory_order_relaxed) };
+         if (!waiting)
+         {
+            deadline = std::chrono::steady_clock::now() + timeout;
+            waiting = true;
+         }
+         wakeWriter_();
+
+         std::unique_lock lck{ roomMtx_ };
+         auto             room = [this]() {
+            return asyncQueue_->size() < async_queue_size || !writerRunning_.load(std::memory_order_acquire);
+         };
+         if (timeout.count() == 0)
+         {
+            roomCv_.wait(lck, room);
+         }
+         else if (!roomCv_.wait_until(lck, deadline, room))
+         {
+            lck.unlock();
+            drop(message);
+            return;
+         }
+      }
+
+      // The writer may have stopped after this thread read the mode, and drained the queue for the last time before
+      // the push. The fence pairs with the one in stopWriter_: either its drain sees the message, or this thread sees
+      // the writer stopped and writes the message itself.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!writerRunning_.load(std::memory_order_relaxed))
+      {
+         while (drainQueue_() > 0U)
+         {
+         }
+         return;
+      }
+
+      // A missed wake-up only delays the message until the writer's next timeout.
+      if (writerWaiting_.load(std::memory_order_relaxed)) wakeWriter_();
+   }
+
+   Log::ShardLease::~ShardLease()
+   {
+      release();
+   }
+
+   void Log::ShardLease::release()
+   {
+      std::shared_ptr<ShardPool> current{ pool.lock() };
+      if (current != nullptr && shard != nullptr)
+      {
+         std::scoped_lock lck{ current->mtx };
+         current->free.emplace_back(shard);
+      }
+
+      owner = 0U;
+      shard = nullptr;
+      pool.reset();
+   }
+
+   Log::RetentionShard& Log::localShard_()
+   {
+      thread_local ShardLease lease;
+
+      if (lease.owner == instance_) return *lease.shard;
+
+      // The thread still holds a shard of a previous logger.
+      lease.release();
+
+      RetentionShard* shard{ nullptr };
+      {
+         std::scoped_lock lck{ shardPool_->mtx };
+         if (!shardPool_->free.empty())
+         {
+            shard = shardPool_->free.back();
+            shardPool_->free.pop_back();
+         }
+         else
+         {
+            shard = shardPool_->shards.emplace_back(std::make_shared<RetentionShard>()).get();
+            shard->next = shardList_.load(std::memory_order_relaxed);
+            shardList_.store(shard, std::memory_order_release);
+         }
+      }
+#ifdef __linux__
+      shard->thread = ::syscall(SYS_gettid);
+#endif
+
+      lease.owner = instance_;
+      lease.shard = shard;
+      lease.pool = shardPool_;
+      return *shard;
+   }
+
+   size_t Log::drainQueue_()
+   {
+      std::scoped_lock lck{ ioMtx_ };
+
+      size_t count{ 0U };
+      while (count < writer_batch_size && asyncQueue_->tryPop(writerMessage_))
+      {
+         write_(writerMessage_);
+         ++count;
+      }
+      if (count > 0U) wakeProducers_();
+
+      // Flush the sinks whose interval expired, even if no message arrived.
+      LogSink::Clock::time_point now{ LogSink::Clock::now() };
+      if (now - lastDropReport_ >= drop_report_interval)
+      {
+         reportDrops_();
+         sweepRepeats_();
+         lastDropReport_ = now;
+      }
+      for (auto& sink : sinks_)
+      {
+         sink->poll(now);
+      }
+
+      return count;
+   }
+
+   bool Log::openSink_(
+      LogSink& sink, std::vector<std::function<void()>>& takeOvers, LogText& failure, std::string& output)
+   {
+      auto fileSink{ dynamic_cast<FileSink*>(&sink) };
+      if (fileSink != nullptr)
+      {
+         FileSink* currentSink{ findSink_<FileSink>([fileSink](const FileSink& current) {
+            return current.fileName() == fileSink->fileName() && current.encoding() == fileSink->encoding();
+         }) };
+         if (currentSink != nullptr)
+         {
+            takeOvers.emplace_back([fileSink, currentSink]() { fileSink->takeOver(*currentSink); });
+            return true;
+         }
+         if (fileSink->init()) return true;
+
+         failure = "Failed to open the log file."_lt;
+         output = fileSink->fileName();
+         return false;
+      }
+
+      // JSON files are opened for appending, so a file already in use is never truncated.
+      auto jsonSink{ dynamic_cast<JsonSink*>(&sink) };
+      if (jsonSink != nullptr && !jsonSink->init())
+      {
+         failure = "Failed to open the log file."_lt;
+         output = jsonSink->fileName();
+         return false;
+      }
+
+#ifdef __linux__
+      auto uringSink{ dynamic_cast<UringFileSink*>(&sink) };
+      if (uringSink != nullptr)
+      {
+         UringFileSink* currentSink{ findSink_<UringFileSink>(
+            [uringSink](const UringFileSink& current) { return current.fileName() == uringSink->fileName(); }) };
+         if (currentSink != nullptr)
+         {
+            takeOvers.emplace_back([uringSink, currentSink]() { uringSink->takeOver(*currentSink); });
+            return true;
+         }
+         if (uringSink->init()) return true;
+
+         failure = "Failed to open the log file."_lt;
+         output = uringSink->fileName();
+         return false;
+      }
+
+      auto mmapSink{ dynamic_cast<MmapFileSink*>(&sink) };
+      if (mmapSink != nullptr)
+      {
+         MmapFileSink* currentSink{ findSink_<MmapFileSink>(
+            [mmapSink](const MmapFileSink& current) { return current.fileName() == mmapSink->fileName(); }) };
+         if (currentSink != nullptr)
+         {
+            takeOvers.emplace_back([mmapSink, currentSink]() { mmapSink->takeOver(*currentSink); });
+            return true;
+         }
+         if (mmapSink->init()) return true;
+
+         failure = "Failed to map the log file."_lt;
+         output = mmapSink->segmentName(0U);
+         return false;
+      }
+
+      // A ring of another size is replaced, readers attached to the current one keep its old contents.
+      auto shmSink{ dynamic_cast<ShmSink*>(&sink) };
+      if (shmSink != nullptr)
+      {
+         ShmSink* currentSink{ findSink_<ShmSink>([shmSink](const ShmSink& current) {
+            return current.name() == shmSink->name() && current.slots() == shmSink->slots() &&
+                   current.slotSize() == shmSink->slotSize();
+         }) };
+         if (currentSink != nullptr)
+         {
+            takeOvers.emplace_back([shmSink, currentSink]() { shmSink->takeOver(*currentSink); });
+            return true;
+         }
+         if (shmSink->init()) return true;
+
+         failure = "Failed to create the shared-memory ring."_lt;
+         output = shmSink->name();
+         return false;
+      }
+#endif
+
+      return true;
+   }
+
+   void Log::reportDrops_()
+   {
+      std::array<std::uint64_t, LogMsg::level_keys.size()> drops{};
+      std::uint64_t                                        total{ 0U };
+      for (size_t level = 0U; level < drops.size(); ++level)
+      {
+         std::uint64_t dropped{ dropped_[level].load(std::memory_order_relaxed) };
+         drops[level] = dropped - reportedDrops_[level];
+         reportedDrops_[level] = dropped;
+         total += drops[level];
+      }
+      if (total == 0U) return;
+
+      using Level = LogMsg::Level;
+      LogMsg report;
+      build_(
+         report,
+         encoding_,
+         Level::warn,
+         timestamp_(),
+         1U,
+         "Logging messages dropped.",
+         pack("number of messages"_lt, total),
+         pack(LogMsg::level_names[static_cast<size_t>(Level::trace)], drops[static_cast<size_t>(Level::trace)]),
+         pack(LogMsg::level_names[static_cast<size_t>(Level::info)], drops[static_cast<size_t>(Level::info)]),
+         pack(LogMsg::level_names[static_cast<size_t>(Level::warn)], drops[static_cast<size_t>(Level::warn)]),
+         pack(LogMsg::level_names[static_cast<size_t>(Level::error)], drops[static_cast<size_t>(Level::error)]),
+         pack(LogMsg::level_names[static_cast<size_t>(Level::fatal)], drops[static_cast<size_t>(Level::fatal)]));
+      write_(report);
+   }
+
+   std::uint64_t Log::samplingSeed_()
+   {
+      // Mix the thread id with the current time through splitmix64, so threads and runs get different sequences.
+      std::uint64_t seed{ std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                          static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) };
+      seed += 0x9E3779B97F4A7C15ULL;
+      seed = (seed ^ (seed >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+      seed = (seed ^ (seed >> 27U)) * 0x94D049BB133111EBULL;
+      seed ^= seed >> 31U;
+      return seed != 0U ? seed : 1U;
+   }
+
+   void Log::sweepRepeats_(bool all)
+   {
+      limiter_.sweep(
+         [this](const LogLimiter::Repeats& repeats) {
+            reportRepeats_(repeats, [this](LogMsg::Level level, LogText text, const auto&... data) {
+               LogMsg report;
+               build_(report, encoding_, level, timestamp_(), 1U, text, data...);
+               write_(report);
+            });
+         },
+         all);
+   }
+
+   void Log::startWriter_()
+   {
+      asyncQueue_ = std::make_unique<cjm::data::ConcurrentQueue<LogMsg, async_queue_size>>();
+      writerRunning_ = true;
+      writer_ = std::thread(&Log::writerLoop_, this);
+      mode_ = Mode::async;
+   }
+
+   void Log::stopWriter_()
+   {
+      if (!writer_.joinable()) return;
+
+      writerRunning_ = false;
+      wakeWriter_();
+      wakeProducers_();
+      writer_.join();
+      mode_ = Mode::sync;
+
+      // Write whatever producers managed to queue while the writer was stopping. Producers that push later see the
+      // writer stopped, thanks to the fence paired with the one in enqueue_, and drain the queue themselves.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (drainQueue_() > 0U)
+      {
+      }
+      {
+         std::scoped_lock lck{ ioMtx_ };
+         reportDrops_();
+      }
+      flush();
+   }
+
+   void Log::updateEncoding_()
+   {
+      // Sinks that do not use text store the raw data, which is only available in binary messages.
+      Encoding encoding{ Encoding::text };
+      for (const auto& sink : sinks_)
+      {
+         if (!sink->needsText()) encoding = Encoding::binary;
+      }
+      encoding_ = encoding;
+   }
+
+   void Log::wakeProducers_()
+   {
+      {
+         std::scoped_lock lck{ roomMtx_ };
+      }
+      roomCv_.notify_all();
+   }
+
+   void Log::wakeWriter_()
+   {
+      {
+         std::scoped_lock lck{ writerMtx_ };
+      }
+      writerCv_.notify_one();
+   }
+
+   void Log::writeContext_(RetentionShard& shard, Delivery delivery)
+   {
+      size_t              size{ contextSize_.load(std::memory_order_relaxed) };
+      size_t              levels{ static_cast<size_t>(logLevel_.load()) };
+      std::vector<LogMsg> context;
+
+      // Take the most recent messages of each level below the logging level that are not in a previous context.
+      auto collect = [&context, size, levels](RetentionShard& current) {
+         std::scoped_lock lck{ current.mtx };
+         for (size_t level = 0U; level < levels; ++level)
+         {
+            const auto&   queue{ current.messages[level] };
+            std::uint64_t pending{ current.pushed[level] - current.written[level] };
+            size_t        count{ static_cast<size_t>(std::min<std::uint64_t>({ pending, queue.size(), size })) };
+            for (size_t i = queue.size() - count; i < queue.size(); ++i)
+            {
+               context.emplace_back(queue[i]);
+            }
+            current.written[level] = current.pushed[level];
+         }
+      };
+
+      if (contextAllThreads_.load(std::memory_order_relaxed))
+      {
+         std::vector<std::shared_ptr<RetentionShard>> shards;
+         {
+            std::scoped_lock lck{ shardPool_->mtx };
+            shards = shardPool_->shards;
+         }
+         for (const auto& current : shards)
+         {
+            collect(*current);
+         }
+      }
+      else
+      {
+         collect(shard);
+      }
+      if (context.empty()) return;
+
+      // Every ring is already sorted, a stable sort keeps the order of messages with the same timestamp.
+      std::stable_sort(context.begin(), context.end(), [](const LogMsg& lhs, const LogMsg& rhs) {
+         return lhs.timestamp() < rhs.timestamp();
+      });
+      auto first{ context.end() - static_cast<std::ptrdiff_t>(std::min(size, context.size())) };
+
+      if (mode_.load(std::memory_order_relaxed) == Mode::async)
+      {
+         for (auto message = first; message != context.end(); ++message)
+         {
+            enqueue_(*message, delivery);
+         }
+      }
+      else
+      {
+         std::scoped_lock lck{ ioMtx_ };
+         for (auto message = first; message != context.end(); ++message)
+         {
+            write_(*message);
+         }
+      }
+   }
+
+   void Log::write_(const LogMsg& message)
+   {
+      LogSink::Clock::time_point now{ LogSink::Clock::now() };
+      bool                       rendered{ false };
+      for (auto& sink : sinks_)
+      {
+         if (!sink->accepts(message)) continue;
+
+         // Format the message once, and only if some sink needs text.
+         if (!rendered && sink->needsText())
+         {
+            renderBuffer_.clear();
+            cjm::fmt::StringOutput output{ renderBuffer_ };
+            if (wallClock_.load(std::memory_order_relaxed))
+            {
+               wallTime_.write(output, startTime_ + message.timestamp());
+               cjm::fmt::write(output, " ");
+            }
+            message.render(output);
+            renderBuffer_ += '\n';
+            rendered = true;
+         }
+
+         sink->write(message, rendered ? std::string_view(renderBuffer_) : std::string_view{}, now);
+      }
+
+      // A sink reports each failure once, so writing the report cannot fail again recursively.
+      std::string output;
+      for (auto& sink : sinks_)
+      {
+         if (!sink->takeFailure(output)) continue;
+
+         LogMsg report;
+         build_(
+            report,
+            encoding_,
+            LogMsg::Level::error,
+            timestamp_(),
+            1U,
+            "Log sink failed."_lt,
+            pack("output"_lt, output));
+         write_(report);
+      }
+   }
+
+   void Log::writerLoop_()
+   {
+      while (writerRunning_.load(std::memory_order_acquire))
+      {
+         if (drainQueue_() > 0U) continue;
+
+         // Nothing to write: sleep until a producer wakes us up or the flush interval expires.
+         std::unique_lock lck{ writerMtx_ };
+         writerWaiting_ = true;
+         writerCv_.wait_for(lck, writer_flush_interval, [this]() {
+            return !asyncQueue_->empty() || !writerRunning_.load(std::memory_order_acquire);
+         });
+         writerWaiting_ = false;
+      }
+
+      while (drainQueue_() > 0U)
+      {
+      }
    }
 } // namespace cjm::io
@@ -25,29 +25,200 @@
 #ifndef COMMON_IO_LOG_HPP
 #define COMMON_IO_LOG_HPP
 
+#include "common/data/BinaryLog.hpp"
 #include "common/data/CircularQueue.hpp"
+#include "common/data/ConcurrentQueue.hpp"
 #include "common/data/LogMsg.hpp"
+#include "common/data/LogText.hpp"
+#include "common/io/FileSink.hpp"
+#include "common/io/LogCategory.hpp"
+#include "common/io/LogClock.hpp"
+#include "common/io/LogFilter.hpp"
+#include "common/io/LogLimiter.hpp"
+#include "common/io/LogSink.hpp"
+#include "common/io/LogSite.hpp"
 
 #include <array>
 #include <atomic>
 #include <chrono>
-#include <fstream>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
+#include <vector>
+
+/**
+ * @brief Lowest logging level that is compiled in: 0 = trace, 1 = info, 2 = warn, 3 = error.
+ * @details Calls below this level made through the CJM_LOG_* macros are removed together with their arguments.
+ */
+#ifndef CJM_LOG_MIN_LEVEL
+   #define CJM_LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * @brief Log a message through a runtime-toggleable cjm::io::LogSite, unless its level is compiled out.
+ * @details The site is registered the first time the call is executed. Arguments are only evaluated if the level is
+ *          compiled in and the site is enabled. Repeated messages of the site are rate limited. The message must be a
+ *          string literal: it is concatenated with an empty _lt literal, so it is kept by pointer, and anything else
+ *          does not compile.
+ */
+#define CJM_LOG_SITE_(logger, level, ...)                                              \
+   do                                                                                  \
+   {                                                                                   \
+      if constexpr (cjm::io::Log::compiled(level))                                     \
+      {                                                                                \
+         using namespace cjm::data::log_literals;                                      \
+         static cjm::io::LogSite cjm_log_site{ __FILE__, __LINE__, __func__, level };  \
+         if (cjm_log_site.enabled()) (logger)->logAt(cjm_log_site, ""_lt __VA_ARGS__); \
+      }                                                                                \
+   } while (false)
+
+/**
+ * @brief Log a trace message, unless trace messages are compiled out or the call site is disabled.
+ */
+#define CJM_LOG_TRACE(logger, ...) CJM_LOG_SITE_(logger, cjm::data::LogMsg::Level::trace, __VA_ARGS__)
+
+/**
+ * @brief Log an information message, unless information messages are compiled out or the call site is disabled.
+ */
+#define CJM_LOG_INFO(logger, ...) CJM_LOG_SITE_(logger, cjm::data::LogMsg::Level::info, __VA_ARGS__)
+
+/**
+ * @brief Log a warning message, unless warning messages are compiled out or the call site is disabled.
+ */
+#define CJM_LOG_WARN(logger, ...) CJM_LOG_SITE_(logger, cjm::data::LogMsg::Level::warn, __VA_ARGS__)
+
+/**
+ * @brief Log a message of a cjm::io::LogCategory through a cjm::io::LogSite, unless its level is compiled out.
+ * @details The level of the category is checked first, so a message disabled in its category costs one array index and
+ *          one atomic load, and its site is not even registered. As with CJM_LOG_SITE_, the message must be a string
+ *          literal.
+ */
+#define CJM_LOG_CATEGORY_SITE_(logger, category, level, ...)                                        \
+   do                                                                                               \
+   {                                                                                                \
+      if constexpr (cjm::io::Log::compiled(level))                                                  \
+      {                                                                                             \
+         if ((category).enabled(level))                                                             \
+         {                                                                                          \
+            using namespace cjm::data::log_literals;                                                \
+            static cjm::io::LogSite cjm_log_site{ __FILE__, __LINE__, __func__, level };            \
+            if (cjm_log_site.enabled()) (logger)->logAt(cjm_log_site, category, ""_lt __VA_ARGS__); \
+         }                                                                                          \
+      }                                                                                             \
+   } while (false)
+
+/**
+ * @brief Log a trace message of a category, unless trace messages are compiled out or disabled.
+ */
+#define CJM_LOG_CAT_TRACE(logger, category, ...) \
+   CJM_LOG_CATEGORY_SITE_(logger, category, cjm::data::LogMsg::Level::trace, __VA_ARGS__)
+
+/**
+ * @brief Log an information message of a category, unless information messages are compiled out or disabled.
+ */
+#define CJM_LOG_CAT_INFO(logger, category, ...) \
+   CJM_LOG_CATEGORY_SITE_(logger, category, cjm::data::LogMsg::Level::info, __VA_ARGS__)
+
+/**
+ * @brief Log a warning message of a category, unless warning messages are compiled out or disabled.
+ */
+#define CJM_LOG_CAT_WARN(logger, category, ...) \
+   CJM_LOG_CATEGORY_SITE_(logger, category, cjm::data::LogMsg::Level::warn, __VA_ARGS__)
+
+namespace cjm::data
+{
+   class BaseSettings;
+}
 
 namespace cjm::io
 {
+   class CrashHandler;
+
    /**
     * @brief Class for logging information.
     */
    class Log
    {
+      friend class CrashHandler;
+
    public:
-      using LogMsg = cjm::data::LogMsg;
+      using LogMsg  = cjm::data::LogMsg;
+      using LogText = cjm::data::LogText;
+
+      /**
+       * @brief Output modes of the logger.
+       */
+      enum class Mode
+      {
+         sync, /**< Messages are written to the outputs by the calling thread. */
+         async /**< Messages are queued and written to the outputs by a dedicated writer thread. */
+      };
+
+      /**
+       * @brief Behaviour of the asynchronous queue when it is full.
+       * @details Messages at error level or above are never dropped, under any policy: they are written directly when
+       *          they would be.
+       */
+      enum class Backpressure
+      {
+         block,       /**< Wait for the writer to make room, up to a timeout, then drop the new message. */
+         drop_newest, /**< Drop the new message. */
+         drop_oldest, /**< Drop the oldest queued message to make room for the new one. */
+         drop_below   /**< Drop the new message if its level is below a threshold, otherwise block. */
+      };
+
+      /**
+       * @brief Messages below the logging level that are written before an error, to give it context.
+       */
+      struct ErrorContext
+      {
+         size_t size{ 0U };          /**< Most recent messages written before an error, 0 to disable. */
+         bool   allThreads{ false }; /**< true to take the messages of every thread, not only of the failing one. */
+      };
+
+      using Encoding = FileSink::Encoding;
+
+      /**
+       * @brief Names of the logging settings nodes.
+       */
+      struct Keys
+      {
+         static constexpr std::string_view node{ "Log" };                   /**< Logging section. */
+         static constexpr std::string_view sink{ "Sink" };                  /**< Sink node, one per sink. */
+         static constexpr std::string_view type{ "type" };                  /**< Attribute with the type of a sink. */
+         static constexpr std::string_view queue{ "Queue" };                /**< Settings of the asynchronous queue. */
+         static constexpr std::string_view backpressure{ "Backpressure" };  /**< Policy of the full queue. */
+         static constexpr std::string_view timeout{ "Timeout" };            /**< Longest wait for room [ms]. */
+         static constexpr std::string_view drop_level{ "DropLevel" };       /**< Threshold of drop_below. */
+         static constexpr std::string_view block{ "block" };                /**< Value of the block policy. */
+         static constexpr std::string_view drop_newest{ "drop_newest" };    /**< Value of the drop_newest policy. */
+         static constexpr std::string_view drop_oldest{ "drop_oldest" };    /**< Value of the drop_oldest policy. */
+         static constexpr std::string_view drop_below{ "drop_below" };      /**< Value of the drop_below policy. */
+         static constexpr std::string_view rate_limit{ "RateLimit" };       /**< Limits of repeated messages. */
+         static constexpr std::string_view rate{ "Rate" };                  /**< Messages per second per call site. */
+         static constexpr std::string_view burst{ "Burst" };                /**< Burst per call site. */
+         static constexpr std::string_view sampling{ "Sampling" };          /**< Sampling rates. */
+         static constexpr std::string_view site{ "Site" };                  /**< Sampling rate of matching sites. */
+         static constexpr std::string_view pattern{ "pattern" };            /**< Attribute with the site pattern. */
+         static constexpr std::string_view error_context{ "ErrorContext" }; /**< Messages written before errors. */
+         static constexpr std::string_view threads{ "threads" };            /**< Attribute selecting the threads. */
+         static constexpr std::string_view all_threads{ "all" };            /**< Take the context of every thread. */
+         static constexpr std::string_view same_thread{ "same" };           /**< Take the context of the same thread. */
+         static constexpr std::string_view crash_dump{ "CrashDump" };       /**< File of the crash dumps, on Linux. */
+         static constexpr std::string_view wall_clock{ "WallClock" };       /**< Date and time of text messages. */
+         static constexpr std::string_view category{ "Category" };          /**< Level of a category of messages. */
+         static constexpr std::string_view name{ "name" };                  /**< Attribute with the category name. */
+         static constexpr std::string_view filter{ "Filter" };              /**< Filter of the recorded messages. */
+         static constexpr std::string_view enabled{ "true" };               /**< Value that enables an option. */
+      };
 
       /**
        * @brief Special codes used in the logging messages.
@@ -83,15 +254,101 @@ namespace cjm::io
       static constexpr std::string_view time_ms{ "ms" };             /**< Millseconds in text. */
       static constexpr std::string_view tab{ "   " };                /**< Tab size for log contents. */
 
-      static constexpr size_t queue_size{ 1024 }; /**< Number of messages that will be stored in a single queue. */
+      static constexpr LogText sample_rate{ LogText::literal("sample rate") }; /**< Datagram with the sampling rate. */
+      static constexpr LogText category_name{ LogText::literal("category") };  /**< Datagram with the category. */
+
+      /**
+       * @brief Lowest logging level that is compiled in.
+       */
+      static constexpr LogMsg::Level min_level{ static_cast<LogMsg::Level>(CJM_LOG_MIN_LEVEL) };
+      static_assert(
+         min_level >= LogMsg::Level::trace && min_level <= LogMsg::Level::error, "Invalid CJM_LOG_MIN_LEVEL.");
+
+      static constexpr size_t queue_size{ 1024 };       /**< Number of messages stored in a single queue. */
+      static constexpr size_t async_queue_size{ 4096 }; /**< Number of messages that can wait for the writer thread. */
+      static constexpr size_t writer_batch_size{ 256 }; /**< Maximum number of messages written in one go. */
+      static constexpr size_t default_generations{ 5 }; /**< Files of previous runs kept by init. */
+
+      /**
+       * @brief Maximum time the writer thread sleeps before checking the queue again.
+       */
+      static constexpr std::chrono::milliseconds writer_flush_interval{ 50 };
+
+      /**
+       * @brief Default longest time a message waits for room in the asynchronous queue.
+       */
+      static constexpr std::chrono::milliseconds default_queue_timeout{ 100 };
+
+      /**
+       * @brief Minimum time between two reports of dropped messages.
+       */
+      static constexpr std::chrono::milliseconds drop_report_interval{ 1000 };
+
+      /**
+       * @brief Destructor. Drains any queued message before destroying the logger.
+       */
+      ~Log();
 
       /********** METHODS *********************************************************************************************/
 
+      /**
+       * @brief Add an output to the logger.
+       * @param sink Sink to add. Ignored if nullptr.
+       */
+      void addSink(std::unique_ptr<LogSink> sink);
+
+      /**
+       * @brief Check whether messages of a given level are compiled in.
+       * @param level Level to check.
+       * @return true or false.
+       */
+      static constexpr bool compiled(LogMsg::Level level)
+      {
+         return level >= min_level;
+      }
+
+      /**
+       * @brief Replace the outputs of the logger with the sinks described in the settings.
+       * @details Every Sink child node describes one sink, selected by its type attribute: console, file, json, memory
+       *          and, on Linux, uring, mmap or shm. The optional Queue node sets the backpressure policy of the async
+       *          queue, RateLimit the limit of repeated messages and Sampling the sampling rates: one child per level,
+       *          named after the level, and Site children whose pattern attribute selects call sites. Category nodes
+       *          set the level of the LogCategory named by their name attribute. The ErrorContext node sets the number
+       *          of context messages written before an error, its threads attribute is either all or same. On Linux,
+       *          the CrashDump node installs a CrashHandler that writes to the given file. WallClock set to true
+       *          prefixes text messages with the date and time. The Filter node sets the filter of the recorded
+       *          messages, and every sink can have its own Filter node, see LogFilter for the syntax. If the settings
+       *          are invalid or a file cannot be opened, the current sinks are kept. A file that is already written by
+       *          a current sink is continued instead of being truncated.
+       * @param settings Logging settings node.
+       * @return true on success, false otherwise.
+       */
+      bool configure(const cjm::data::BaseSettings& settings);
+
+      /**
+       * @brief Get the number of messages of a level dropped by the asynchronous queue so far.
+       * @param level Level of the messages.
+       * @return Number of dropped messages.
+       */
+      std::uint64_t dropped(LogMsg::Level level) const;
+
+      /**
+       * @brief Get the context written before an error.
+       * @return Current error context.
+       */
+      ErrorContext errorContext() const;
+
+      /**
+       * @brief Check whether the text of the messages starts with the date and time.
+       * @return true or false.
+       */
+      bool wallClock() const;
+
       /**
        * @brief Log an error message.
        */
       template<typename... Args>
-      void error(std::string_view msg, const Args&... args)
+      void error(LogText msg, const Args&... args)
       {
          log(LogMsg::Level::error, msg, args...);
       }
@@ -100,27 +357,43 @@ namespace cjm::io
        * @brief Log a fatal error message.
        */
       template<typename... Args>
-      void fatal(std::string_view msg, const Args&... args)
+      void fatal(LogText msg, const Args&... args)
       {
          log(LogMsg::Level::fatal, msg, args...);
       }
 
       /**
-       * @brief Initialise the logger.
+       * @brief Flush every sink, after writing the summaries of every suppressed repeat.
+       */
+      void flush();
+
+      /**
+       * @brief Initialise the logger with a console sink and a file sink.
+       * @details The files of the previous runs are kept as <logFile>.1, <logFile>.2, ... up to default_generations.
        * @param logFile Path of the output file to use for logging.
+       * @param mode Output mode of the logger.
+       * @param encoding Encoding of the log file. Binary files can be converted to text with cjm-logdecode.
        * @return true on success, false otherwise.
        */
-      static bool init(std::string_view logFile);
+      static bool init(std::string_view logFile, Mode mode = Mode::sync, Encoding encoding = Encoding::text);
 
       /**
        * @brief Log an information message.
+       * @details The call does nothing if information messages are compiled out, use CJM_LOG_INFO to also skip the
+       *          evaluation of the arguments.
        */
       template<typename... Args>
-      void info(std::string_view msg, const Args&... args)
+      void info(LogText msg, const Args&... args)
       {
-         log(LogMsg::Level::info, msg, args...);
+         if constexpr (compiled(LogMsg::Level::info)) log(LogMsg::Level::info, msg, args...);
       }
 
+      /**
+       * @brief Get the expression of the filter of the recorded messages.
+       * @return Expression of the filter, empty if every message is recorded.
+       */
+      std::string filter() const;
+
       /**
        * @brief Get the current logging level.
        * @return Current logging level.
@@ -134,29 +407,65 @@ namespace cjm::io
        * @param args Optional variables to print. Should be a pair (description, variable).
        */
       template<typename... Args>
-      void log(LogMsg::Level level, std::string_view msg, const Args&... args)
+      void log(LogMsg::Level level, LogText msg, const Args&... args)
       {
-         if (!initialised_) return;
+         std::uint32_t sampling{ sampling_[static_cast<size_t>(level)].load(std::memory_order_relaxed) };
+         if (sampled_(sampling)) record_(level, sampling, Delivery::wait, msg, args...);
+      }
 
-         // Create and store the logging message and data.
-         auto timestamp{
-            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime_).count()
-         };
+      /**
+       * @brief Log a message of a category, unless the level is disabled in the category.
+       * @param category Category of the message. Its name is added to the data of the message.
+       * @param level Desired logging level.
+       * @param msg Message to print on the first line.
+       * @param args Optional variables to print. Should be a pair (description, variable).
+       */
+      template<typename... Args>
+      void log(const LogCategory& category, LogMsg::Level level, LogText msg, const Args&... args)
+      {
+         if (category.enabled(level)) log(level, msg, args..., pack(category_name, category.name()));
+      }
 
-         std::scoped_lock lck{ ioMtx_ };
-         auto&            newMessage = messages_[static_cast<int>(level)].push(LogMsg(level, timestamp, msg));
-         // If there is additional data, add it to the message.
-         if constexpr (sizeof...(Args) > 0) (newMessage.addData(args), ...);
+      /**
+       * @brief Log a message from a call site, unless it is sampled out or repeated too often.
+       * @details Used by the CJM_LOG_* macros. The sampling rate of the site, if set, replaces the one of its level.
+       *          When the message is logged after some of its repeats were suppressed, a summary of the repeats is
+       *          logged first.
+       * @param site Site of the call.
+       * @param msg Message to print on the first line.
+       * @param args Optional variables to print. Should be a pair (description, variable).
+       */
+      template<typename... Args>
+      void logAt(const LogSite& site, LogText msg, const Args&... args)
+      {
+         std::uint32_t sampling{ site.sampling() };
+         if (sampling == 0U) sampling = sampling_[static_cast<size_t>(site.level())].load(std::memory_order_relaxed);
+         if (!sampled_(sampling)) return;
 
-         // If the message level is high enough, print the basic message information.
-         if (level >= logLevel_)
-         {
-            // Log on stdio.
-            std::cout << level_ansi_colours[static_cast<int>(level)] << newMessage.baseMessage() << '\n';
+         LogLimiter::Repeats repeats;
+         if (!limiter_.admit(site, msg, repeats)) return;
 
-            // Log on file.
-            outputFile_ << newMessage.baseMessage() << '\n';
+         if (repeats.count > 0U)
+         {
+            reportRepeats_(repeats, [this](LogMsg::Level level, LogText text, const auto&... data) {
+               record_(level, 1U, Delivery::wait, text, data...);
+            });
          }
+         record_(site.level(), sampling, Delivery::wait, msg, args...);
+      }
+
+      /**
+       * @brief Log a message of a category from a call site, unless it is sampled out or repeated too often.
+       * @details Used by the CJM_LOG_CAT_* macros, which check the level of the category beforehand.
+       * @param site Site of the call.
+       * @param category Category of the message. Its name is added to the data of the message.
+       * @param msg Message to print on the first line.
+       * @param args Optional variables to print. Should be a pair (description, variable).
+       */
+      template<typename... Args>
+      void logAt(const LogSite& site, const LogCategory& category, LogText msg, const Args&... args)
+      {
+         logAt(site, msg, args..., pack(category_name, category.name()));
       }
 
       /**
@@ -165,75 +474,539 @@ namespace cjm::io
        */
       static Log* logger();
 
+      /**
+       * @brief Get the current output mode of the logger.
+       * @return Current output mode.
+       */
+      Mode mode() const;
+
       /**
        * @brief Pack all information necessary for a logging datagram.
        * @tparam Data type to store.
-       * @param description Description of the data.
+       * @param description Description of the data. Kept by pointer, and interned in binary messages, if marked as a
+       *                    literal with the _lt suffix, otherwise copied.
        * @param data Data to store.
        * @return Pair containing both the description
        */
       template<typename T>
-      static constexpr std::pair<const char*, const T&> pack(const char* description, const T& data)
+      static constexpr std::pair<LogText, const T&> pack(LogText description, const T& data)
       {
-         return std::pair<const char*, const T&>(description, data);
+         return std::pair<LogText, const T&>(description, data);
       }
 
       /**
-       * @brief Pack all information necessary for a logging datagram.
-       * @tparam Data type to store.
-       * @param description Description of the data.
-       * @param data Data to store.
-       * @return Pair containing both the description
+       * @brief Log a message without ever waiting for the writer thread.
+       * @details Meant for debug, info and warning messages of callers that must not stall, like handlers of
+       *          third-party diagnostics on the GUI thread. Errors should go through log() instead. In async mode, a
+       *          message that finds the queue full is dropped and counted as with Backpressure::drop_newest, whatever
+       *          the policy, and so is the context of an error. Errors themselves are never dropped and are written
+       *          directly instead. In sync mode, the message is written like any other.
+       * @param level Desired logging level.
+       * @param msg Message to print on the first line.
+       * @param args Optional variables to print. Should be a pair (description, variable).
        */
-      template<typename T>
-      static constexpr std::pair<const char*, const T&> pack(std::string_view description, const T& data)
+      template<typename... Args>
+      void post(LogMsg::Level level, LogText msg, const Args&... args)
       {
-         return std::pair<const char*, const T&>(description.data(), data);
+         std::uint32_t sampling{ sampling_[static_cast<size_t>(level)].load(std::memory_order_relaxed) };
+         if (sampled_(sampling)) record_(level, sampling, Delivery::no_wait, msg, args...);
       }
 
       /**
        * @brief Log a trace message.
+       * @details The call does nothing if trace messages are compiled out, use CJM_LOG_TRACE to also skip the
+       *          evaluation of the arguments.
        */
       template<typename... Args>
-      void trace(std::string_view msg, const Args&... args)
+      void trace(LogText msg, const Args&... args)
       {
-         log(LogMsg::Level::trace, msg, args...);
+         if constexpr (compiled(LogMsg::Level::trace)) log(LogMsg::Level::trace, msg, args...);
       }
 
+      /**
+       * @brief Set the behaviour of the asynchronous queue when it is full.
+       * @param policy Backpressure policy.
+       * @param timeout Longest wait for room, used by block and drop_below. 0 waits without limit.
+       * @param dropLevel Messages below this level are dropped by drop_below.
+       */
+      void setBackpressure(
+         Backpressure              policy,
+         std::chrono::milliseconds timeout = default_queue_timeout,
+         LogMsg::Level             dropLevel = LogMsg::Level::warn);
+
+      /**
+       * @brief Set the context written before an error.
+       * @details While enabled, messages below the logging level are stored unformatted in the retention rings. When
+       *          an error or fatal message is written, the most recent of them that were not written yet are written
+       *          first, in timestamp order.
+       * @param context New error context.
+       */
+      void setErrorContext(const ErrorContext& context);
+
+      /**
+       * @brief Prefix the text of the messages with the local date and time at which they were created.
+       * @param enabled true to write the date and time, false to only write the timestamps.
+       */
+      void setWallClock(bool enabled);
+
+      /**
+       * @brief Set the filter of the recorded messages.
+       * @details The filter is evaluated before a message is built, on its level, its text and the data it compares:
+       *          rejected messages are neither stored in the retention rings nor written to any sink. Sinks can have
+       *          their own filter on top of it.
+       * @param expression Filter expression, see LogFilter. An empty expression records every message.
+       * @return true on success, false on a syntax error, in which case the current filter is kept.
+       */
+      bool setFilter(std::string_view expression);
+
+      /**
+       * @brief Set the rate limit of repeated messages from the same call site.
+       * @param rate Messages per second, 0 to disable limiting.
+       * @param burst Messages that can be logged at once.
+       */
+      void setRateLimit(std::uint32_t rate, std::uint32_t burst);
+
+      /**
+       * @brief Set the sampling rate of a level.
+       * @details Sampled out messages are discarded before being built. The rate of a call site, if set, replaces the
+       *          one of its level. Logged messages of a sampled level carry the rate in a "sample rate" datagram.
+       * @param level Level of the messages.
+       * @param sampling N to log one message in N, 0 or 1 to log every message.
+       */
+      void setSampling(LogMsg::Level level, std::uint32_t sampling);
+
       /**
        * @brief Set the logging level.
        * @param level New logging level.
        */
       void setLevel(LogMsg::Level level);
 
+      /**
+       * @brief Get a copy of the retained messages of every thread, sorted by timestamp.
+       * @param minLevel Minimum level of the returned messages.
+       * @return Retained messages, from the oldest to the newest.
+       */
+      std::vector<LogMsg> snapshot(LogMsg::Level minLevel = LogMsg::Level::trace) const;
+
+      /**
+       * @brief Stop the writer thread after all queued messages have been written.
+       * @details The logger keeps working in synchronous mode afterwards, so late messages are not lost.
+       */
+      static void shutdown();
+
       /**
        * @brief Log a warning message.
+       * @details The call does nothing if warning messages are compiled out, use CJM_LOG_WARN to also skip the
+       *          evaluation of the arguments.
        */
       template<typename... Args>
-      void warn(std::string_view msg, const Args&... args)
+      void warn(LogText msg, const Args&... args)
       {
-         log(LogMsg::Level::warn, msg, args...);
+         if constexpr (compiled(LogMsg::Level::warn)) log(LogMsg::Level::warn, msg, args...);
       }
 
    private:
+      /**
+       * @brief Behaviours of a message that finds the asynchronous queue full.
+       */
+      enum class Delivery
+      {
+         wait,   /**< Follow the backpressure policy, which may wait for the writer. */
+         no_wait /**< Drop the message. */
+      };
+
+      /**
+       * @brief Retention rings owned by a single thread.
+       * @details The mutex is only shared between the owning thread and snapshot readers, so logging threads never
+       *          contend with each other.
+       */
+      struct RetentionShard
+      {
+         std::mutex mtx; /**< Mutex protecting the rings. */
+
+         /**
+          * @brief Message queues, one per level.
+          */
+         std::array<cjm::data::CircularQueue<LogMsg, queue_size>, LogMsg::level_keys.size()> messages;
+
+         std::array<std::uint64_t, LogMsg::level_keys.size()> pushed{};  /**< Messages pushed per level. */
+         std::array<std::uint64_t, LogMsg::level_keys.size()> written{}; /**< Pushed messages already in a context. */
+
+         long            thread{ 0 };     /**< Kernel id of the owning thread, on Linux. */
+         RetentionShard* next{ nullptr }; /**< Next shard in the list read by the crash handler. */
+      };
+
+      /**
+       * @brief Retention shards of a logger.
+       * @details Shared with the threads that hold one of the shards, so that a thread exiting after the logger is
+       *          destroyed does not return its shard to a dead logger.
+       */
+      struct ShardPool
+      {
+         std::mutex mtx; /**< Mutex protecting the lists of shards. */
+
+         /**
+          * @brief Every shard created so far. Shards outlive their threads, so their history stays available to
+          *        snapshots until the shard is lent to a new thread.
+          */
+         std::vector<std::shared_ptr<RetentionShard>> shards;
+         std::vector<RetentionShard*>                 free; /**< Shards whose thread has exited. */
+      };
+
+      /**
+       * @brief Retention shard lent to a thread, returned to the free list of its logger when the thread exits.
+       */
+      struct ShardLease
+      {
+         std::uint64_t            owner{ 0U };      /**< Instance id of the logger of the shard, 0 if none. */
+         RetentionShard*          shard{ nullptr }; /**< Shard lent to the thread. */
+         std::weak_ptr<ShardPool> pool;             /**< Pool the shard is returned to. */
+
+         /**
+          * @brief Destructor. Returns the shard to its pool.
+          */
+         ~ShardLease();
+
+         /**
+          * @brief Return the shard to its pool, if the pool still exists.
+          */
+         void release();
+      };
+
       /**
        * @brief Constructor.
        */
       Log() = default;
 
-      static bool                 initialised_; /**< true if the logger was initialised. */
-      static std::unique_ptr<Log> logger_;      /**< Single instance of the logger. */
+      /**
+       * @brief Fill a message in the encoding currently used by the sinks.
+       * @param message Message to fill. Its memory is reused.
+       * @param encoding Encoding of the message.
+       * @param level Level of the message.
+       * @param timestamp Timestamp of the message, since the logger was initialised [ns].
+       * @param sampling Sampling rate of the message, added as a datagram if greater than 1.
+       * @param msg Text of the message.
+       * @param args Optional variables to print. Should be a pair (description, variable).
+       */
+      template<typename... Args>
+      void build_(
+         LogMsg&          message,
+         Encoding         encoding,
+         LogMsg::Level    level,
+         long long        timestamp,
+         std::uint32_t    sampling,
+         LogText          msg,
+         const Args&... args)
+      {
+         if (encoding == Encoding::binary)
+         {
+            // Only copy the raw data, formatting is left to the writer.
+            message.resetBinary(level, timestamp, msg);
+            if constexpr (sizeof...(Args) > 0) (message.addBinaryData(args), ...);
+            if (sampling > 1U) message.addBinaryData(pack(sample_rate, sampling));
+         }
+         else
+         {
+            message.reset(level, timestamp, msg);
+            // If there is additional data, add it to the message.
+            if constexpr (sizeof...(Args) > 0) (message.addData(args), ...);
+            if (sampling > 1U) message.addData(pack(sample_rate, sampling));
+         }
+      }
+
+      /**
+       * @brief Queue a message for the writer thread.
+       * @details If the queue is full, the backpressure policy decides whether the caller waits for the writer to
+       *          make room or a message is dropped. Errors that would be dropped, including those evicted by
+       *          drop_oldest, are written directly instead. If the writer has already been stopped, the message is
+       *          written directly.
+       * @param message Message to queue. It is copied into the queue, reusing the memory of the queue slot.
+       * @param delivery Delivery::no_wait drops the message if the queue is full, whatever the policy, unless it is
+       *                 an error.
+       */
+      void enqueue_(const LogMsg& message, Delivery delivery = Delivery::wait);
+
+      /**
+       * @brief Find the current sink of a type that writes the same output as a new sink. Called with ioMtx_ held.
+       * @param match Function that checks whether a current sink of the type writes the same output.
+       * @return Matching current sink, or nullptr.
+       */
+      template<typename Sink, typename Match>
+      Sink* findSink_(const Match& match)
+      {
+         for (auto& current : sinks_)
+         {
+            auto currentSink{ dynamic_cast<Sink*>(current.get()) };
+            if (currentSink != nullptr && match(*currentSink)) return currentSink;
+         }
+
+         return nullptr;
+      }
+
+      /**
+       * @brief Open the output of a new sink, or plan to take it over from the current sink that writes it, so that
+       *        it is not truncated. Called with ioMtx_ held, once every new sink is valid.
+       * @param sink New sink.
+       * @param takeOvers Take-overs to run once every new sink is opened.
+       * @param failure Description of the failure, set on failure.
+       * @param output Output that could not be opened, set on failure.
+       * @return true on success, false otherwise.
+       */
+      bool openSink_(
+         LogSink& sink, std::vector<std::function<void()>>& takeOvers, LogText& failure, std::string& output);
+
+      /**
+       * @brief Get the retention shard of the calling thread in this logger.
+       * @details On first use, the thread takes a shard left by an exited thread, or registers a new one.
+       * @return Retention shard of the calling thread.
+       */
+      RetentionShard& localShard_();
+
+      /**
+       * @brief Write a batch of queued messages to the sinks and flush the sinks whose interval expired.
+       * @return Number of written messages.
+       */
+      size_t drainQueue_();
+
+      /**
+       * @brief Store a message in the retention ring of the calling thread and write it, if its level is enabled.
+       * @param level Level of the message.
+       * @param sampling Sampling rate of the message.
+       * @param delivery Behaviour of the message if the asynchronous queue is full.
+       * @param msg Text of the message.
+       * @param args Optional variables to print. Should be a pair (description, variable).
+       */
+      template<typename... Args>
+      void record_(LogMsg::Level level, std::uint32_t sampling, Delivery delivery, LogText msg, const Args&... args)
+      {
+         if (!initialised_) return;
+
+         // Filter the message before building it, formatting only the data the filter compares.
+         const LogFilter* filter{ filter_.load(std::memory_order_acquire) };
+         if (filter != nullptr && !filter->accepts(level, msg, args...)) return;
+
+         // Create and store the logging message and data.
+         long long timestamp{ timestamp_() };
+
+         // Rebuild the oldest message of the retention ring in place, reusing its memory.
+         // Only the calling thread writes into its shard, so the message can be read back without the lock.
+         RetentionShard& shard{ localShard_() };
+         LogMsg*         newMessage{ nullptr };
+         bool            written{ level >= logLevel_ };
+         bool            context{ contextSize_.load(std::memory_order_relaxed) > 0U };
+         {
+            std::scoped_lock lck{ shard.mtx };
+            newMessage = &shard.messages[static_cast<int>(level)].pushInPlace();
+            ++shard.pushed[static_cast<size_t>(level)];
+
+            // Messages only kept as context may never be written, so they are not formatted.
+            Encoding encoding{ !written && context ? Encoding::binary : encoding_.load() };
+            build_(*newMessage, encoding, level, timestamp, sampling, msg, args...);
+         }
+
+         // If the message level is high enough, print the basic message information.
+         if (!written) return;
+
+         if (context && level >= LogMsg::Level::error) writeContext_(shard, delivery);
+
+         if (mode_.load(std::memory_order_relaxed) == Mode::async)
+         {
+            enqueue_(*newMessage, delivery);
+
+            // A fatal message is written before returning, the process may not live long enough for the writer.
+            if (level == LogMsg::Level::fatal)
+            {
+               while (drainQueue_() == writer_batch_size)
+               {
+               }
+            }
+         }
+         else
+         {
+            std::scoped_lock lck{ ioMtx_ };
+            write_(*newMessage);
+         }
+      }
+
+      /**
+       * @brief Write a summary of the messages dropped since the last one, if any. Called with ioMtx_ held.
+       */
+      void reportDrops_();
+
+      /**
+       * @brief Log a summary of suppressed repeats.
+       * @param repeats Suppressed repeats.
+       * @param emit Callable that logs a message, invoked with its level, text and datagrams.
+       */
+      template<typename Emit>
+      static void reportRepeats_(const LogLimiter::Repeats& repeats, Emit emit)
+      {
+         using namespace cjm::data::log_literals;
+
+         emit(
+            repeats.level,
+            "Message repeated."_lt,
+            pack("message"_lt, repeats.message()),
+            pack("times"_lt, repeats.count),
+            pack("in [ms]"_lt, repeats.period.count()),
+            pack("file"_lt, repeats.site->file()),
+            pack("line"_lt, repeats.site->line()));
+      }
+
+      /**
+       * @brief Decide whether a sampled message is logged.
+       * @details Uses a xorshift64* generator private to the calling thread, so the decision takes a few instructions
+       *          and no shared state.
+       * @param sampling N to log one message in N, 0 or 1 to log every message.
+       * @return true if the message is logged.
+       */
+      static bool sampled_(std::uint32_t sampling)
+      {
+         if (sampling <= 1U) return true;
 
-      std::mutex    ioMtx_;      /**< Mutex for protecting the standard IO stream. */
-      std::ofstream outputFile_; /**< Logging file. */
+         thread_local std::uint64_t state{ 0U };
+         if (state == 0U) state = samplingSeed_();
+         state ^= state >> 12U;
+         state ^= state << 25U;
+         state ^= state >> 27U;
+
+         // Map the upper 32 random bits onto [0, sampling) without a division.
+         std::uint64_t random{ (state * 0x2545F4914F6CDD1DULL) >> 32U };
+         return ((random * sampling) >> 32U) == 0U;
+      }
+
+      /**
+       * @brief Get a non-zero seed for the sampling generator of the calling thread.
+       * @return Seed.
+       */
+      static std::uint64_t samplingSeed_();
+
+      /**
+       * @brief Write the summaries of the bursts of repeats that ended. Called with ioMtx_ held.
+       * @param all If true, also write the summaries of the bursts still going on.
+       */
+      void sweepRepeats_(bool all = false);
+
+      /**
+       * @brief Get the timestamp of a message created now.
+       * @return Time since the logger was initialised [ns].
+       */
+      long long timestamp_() const
+      {
+         return LogClock::now() - startTime_;
+      }
+
+      /**
+       * @brief Start the writer thread.
+       */
+      void startWriter_();
+
+      /**
+       * @brief Stop the writer thread and write every message still in the queue.
+       */
+      void stopWriter_();
+
+      /**
+       * @brief Store new messages in binary form if any sink needs their raw data. Called with ioMtx_ held.
+       */
+      void updateEncoding_();
+
+      /**
+       * @brief Wake up the producers waiting for room in the queue.
+       */
+      void wakeProducers_();
+
+      /**
+       * @brief Wake up the writer thread if it is waiting for new messages.
+       */
+      void wakeWriter_();
+
+      /**
+       * @brief Write the context of an error: the most recent messages below the logging level not written yet.
+       * @param shard Retention shard of the calling thread.
+       * @param delivery Behaviour of the context messages if the asynchronous queue is full.
+       */
+      void writeContext_(RetentionShard& shard, Delivery delivery);
+
+      /**
+       * @brief Write a message on every sink that accepts its level. Called with ioMtx_ held.
+       * @param message Message to write.
+       */
+      void write_(const LogMsg& message);
+
+      /**
+       * @brief Main loop of the writer thread.
+       */
+      void writerLoop_();
+
+      static bool                       initialised_; /**< true if the logger was initialised. */
+      static std::unique_ptr<Log>       logger_;      /**< Single instance of the logger. */
+      static std::atomic<std::uint64_t> instances_;   /**< Number of loggers created so far. */
+
+      const std::uint64_t instance_{ ++instances_ }; /**< Id of the logger, which keys the thread-local shards. */
+
+      std::mutex                            ioMtx_;              /**< Mutex protecting the sinks. */
+      std::vector<std::unique_ptr<LogSink>> sinks_;              /**< Outputs of the logger. */
+      std::string                           renderBuffer_;       /**< Text of the message being written. */
+      WallClock                             wallTime_;           /**< Cached date and time of the written messages. */
+      std::atomic<bool>                     wallClock_{ false }; /**< true to write the date and time. */
+
+      std::atomic<Encoding> encoding_{ Encoding::text }; /**< Encoding used to store new messages. */
 
       std::atomic<LogMsg::Level> logLevel_{ LogMsg::Level::trace };  /**< Current logging level. */
-      std::chrono::time_point<std::chrono::steady_clock> startTime_; /**< Starting time of the program. */
+      std::atomic<Mode>          mode_{ Mode::sync };                /**< Current output mode. */
+      std::int64_t               startTime_{ 0 };                    /**< Starting time of the program [ns]. */
+
+      std::shared_ptr<ShardPool> shardPool_{ std::make_shared<ShardPool>() }; /**< Retention shards. */
+
+      /**
+       * @brief Most recently registered shard. The shards are linked without locks, so a signal handler can walk them.
+       */
+      std::atomic<RetentionShard*> shardList_{ nullptr };
+
+      /**
+       * @brief Messages waiting for the writer thread. Only allocated in asynchronous mode.
+       */
+      std::unique_ptr<cjm::data::ConcurrentQueue<LogMsg, async_queue_size>> asyncQueue_;
+      LogMsg writerMessage_; /**< Message popped by the writer thread, kept to reuse its memory. */
+
+      std::atomic<Backpressure>              backpressure_{ Backpressure::block };   /**< Policy of the full queue. */
+      std::atomic<std::chrono::milliseconds> queueTimeout_{ default_queue_timeout }; /**< Longest wait for room. */
+      std::atomic<LogMsg::Level>             dropLevel_{ LogMsg::Level::warn };      /**< Threshold of drop_below. */
+
+      /**
+       * @brief Messages dropped by the asynchronous queue per level, the part of them already reported and the time of
+       *        the last report. Reports are written by the writer thread.
+       */
+      std::array<std::atomic<std::uint64_t>, LogMsg::level_keys.size()> dropped_{};
+      std::array<std::uint64_t, LogMsg::level_keys.size()>              reportedDrops_{};
+      LogSink::Clock::time_point                                        lastDropReport_;
+
+      LogLimiter limiter_; /**< Rate limit of repeated messages. */
+
+      /**
+       * @brief Filter of the recorded messages, nullptr to record every message. Replaced filters are kept until the
+       *        logger is destroyed, since other threads may still be evaluating them.
+       */
+      std::atomic<const LogFilter*>           filter_{ nullptr };
+      std::vector<std::unique_ptr<LogFilter>> filters_;    /**< Every filter set so far. */
+      mutable std::mutex                      filtersMtx_; /**< Mutex protecting the filters. */
+
+      std::atomic<size_t> contextSize_{ 0U };          /**< Messages written before an error. */
+      std::atomic<bool>   contextAllThreads_{ false }; /**< true to take the context of every thread. */
 
       /**
-       * @brief Message queues.
+       * @brief Sampling rate of each level, 0 or 1 to log every message.
        */
-      std::array<cjm::data::CircularQueue<LogMsg, queue_size>, LogMsg::level_keys.size()> messages_;
+      std::array<std::atomic<std::uint32_t>, LogMsg::level_keys.size()> sampling_{};
+
+      std::thread             writer_;                 /**< Thread that writes queued messages to the outputs. */
+      std::mutex              writerMtx_;              /**< Mutex used to put the writer thread to sleep. */
+      std::condition_variable writerCv_;               /**< Condition variable used to wake up the writer thread. */
+      std::atomic<bool>       writerRunning_{ false }; /**< true while the writer thread accepts new messages. */
+      std::atomic<bool>       writerWaiting_{ false }; /**< true while the writer thread is waiting for messages. */
+      std::mutex              roomMtx_;                /**< Mutex used to put producers to sleep on a full queue. */
+      std::condition_variable roomCv_;                 /**< Condition variable signalled when the queue has room. */
    };
 } // namespace cjm::io
 
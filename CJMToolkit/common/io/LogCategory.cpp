@@ -0,0 +1,116 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "LogCategory.hpp"
+
+#include <algorithm>
+
+namespace cjm::io
+{
+   using cjm::data::LogMsg;
+
+   /********** STATIC VARIABLES DEFINITIONS **********/
+   std::array<std::atomic<std::uint64_t>, LogCategory::table_size> LogCategory::levels_{};
+
+   std::vector<std::pair<std::string, LogMsg::Level>> LogCategory::rules_;
+   std::mutex                                         LogCategory::mtx_;
+
+   /********** METHOD DEFINITIONS **********/
+   LogMsg::Level LogCategory::level() const
+   {
+      return level(name_);
+   }
+
+   LogMsg::Level LogCategory::level(std::string_view name)
+   {
+      std::scoped_lock lck{ mtx_ };
+      return inherited_(name);
+   }
+
+   void LogCategory::resetLevel(std::string_view name)
+   {
+      std::scoped_lock lck{ mtx_ };
+      auto rule = std::find_if(rules_.begin(), rules_.end(), [name](const auto& rule) { return rule.first == name; });
+      if (rule == rules_.end()) return;
+
+      rules_.erase(rule);
+      invalidate_();
+   }
+
+   void LogCategory::setLevel(std::string_view name, LogMsg::Level level)
+   {
+      std::scoped_lock lck{ mtx_ };
+      auto rule = std::find_if(rules_.begin(), rules_.end(), [name](const auto& rule) { return rule.first == name; });
+      if (rule != rules_.end())
+      {
+         rule->second = level;
+      }
+      else
+      {
+         rules_.emplace_back(name, level);
+      }
+      invalidate_();
+   }
+
+   LogMsg::Level LogCategory::inherited_(std::string_view name)
+   {
+      // The closest ancestor is the longest name that is either the name itself or a prefix followed by a separator.
+      LogMsg::Level level{ LogMsg::Level::trace };
+      size_t        closest{ 0U };
+      for (const auto& [ruleName, ruleLevel] : rules_)
+      {
+         bool ancestor{ ruleName.empty() || name == ruleName ||
+                        (name.size() > ruleName.size() && name.compare(0U, ruleName.size(), ruleName) == 0 &&
+                         name[ruleName.size()] == separator) };
+         if (ancestor && ruleName.size() >= closest)
+         {
+            level = ruleLevel;
+            closest = ruleName.size();
+         }
+      }
+      return level;
+   }
+
+   void LogCategory::invalidate_()
+   {
+      for (auto& level : levels_)
+      {
+         level.store(unresolved, std::memory_order_relaxed);
+      }
+   }
+
+   bool LogCategory::resolve_(LogMsg::Level level) const
+   {
+      std::scoped_lock lck{ mtx_ };
+      LogMsg::Level    current{ inherited_(name_) };
+
+      // A slot holding the level of another category keeps it: this one is resolved on every check instead.
+      std::uint64_t stored{ levels_[slot_].load(std::memory_order_relaxed) };
+      if ((stored & level_mask) == unresolved || (stored & ~level_mask) == owner_)
+      {
+         levels_[slot_].store(owner_ | (static_cast<std::uint64_t>(current) + 1U), std::memory_order_relaxed);
+      }
+      return level >= current;
+   }
+} // namespace cjm::io
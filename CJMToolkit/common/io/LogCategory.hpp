@@ -0,0 +1,184 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_LOGCATEGORY_HPP
+#define COMMON_IO_LOGCATEGORY_HPP
+
+#include "common/data/LogMsg.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cjm::io
+{
+   /**
+    * @brief Named logging category, such as settings.xml or ui.construct, with its own logging level.
+    * @details Names are hierarchical, with dots between their parts: a category without a level of its own takes the
+    *          level of its closest ancestor that has one, e.g. ui for ui.construct. Categories without any level
+    *          enable every message, the level of the logger still applies afterwards.
+    *          Categories should be declared constexpr, so that their slot in the table of levels is hashed from their
+    *          name at compile time: checking a level is then one array index and one atomic load. The level of a slot
+    *          is resolved from the name of its category the first time it is checked after a change, and stored along
+    *          with the upper bits of the category id. A category whose slot holds the level of another one, because
+    *          both names hash to the same slot, resolves its level again on every check, which is slower but correct.
+    */
+   class LogCategory
+   {
+   public:
+      using LogMsg = cjm::data::LogMsg;
+
+      static constexpr size_t table_size{ 4096U }; /**< Number of slots in the table of levels. */
+      static constexpr char   separator{ '.' };    /**< Separator between the parts of a name. */
+
+      static_assert(table_size >= 256U, "The id bits left by the slot must fit next to the level.");
+
+      /**
+       * @brief Create a category.
+       * @param name Name of the category. Only a view is kept, the name should be a string literal.
+       */
+      constexpr explicit LogCategory(std::string_view name) :
+         name_{ name }, id_{ hash(name) }, slot_{ static_cast<size_t>(id_ % table_size) },
+         owner_{ (id_ / table_size) << level_bits }
+      {
+      }
+
+      /**
+       * @brief Check whether messages of a level are enabled in the category.
+       * @param level Level of the messages.
+       * @return true or false.
+       */
+      bool enabled(LogMsg::Level level) const
+      {
+         std::uint64_t current{ levels_[slot_].load(std::memory_order_relaxed) };
+         std::uint64_t stored{ current & level_mask };
+         if (stored == unresolved || (current & ~level_mask) != owner_) return resolve_(level);
+         return static_cast<std::uint64_t>(level) + 1U >= stored;
+      }
+
+      /**
+       * @brief Hash a category name. The hash of a literal is a compile-time constant.
+       * @param name Name of the category.
+       * @return FNV-1a hash of the name.
+       */
+      static constexpr std::uint64_t hash(std::string_view name)
+      {
+         std::uint64_t result{ 14695981039346656037ULL };
+         for (char character : name)
+         {
+            result ^= static_cast<unsigned char>(character);
+            result *= 1099511628211ULL;
+         }
+         return result;
+      }
+
+      /**
+       * @brief Get the id of the category.
+       * @return Hash of the name.
+       */
+      constexpr std::uint64_t id() const
+      {
+         return id_;
+      }
+
+      /**
+       * @brief Get the level of the category, set on it or inherited from its ancestors.
+       * @return Lowest enabled level.
+       */
+      LogMsg::Level level() const;
+
+      /**
+       * @brief Get the level of a category name, set on it or inherited from its ancestors.
+       * @param name Name of the category.
+       * @return Lowest enabled level.
+       */
+      static LogMsg::Level level(std::string_view name);
+
+      /**
+       * @brief Get the name of the category.
+       * @return Name of the category.
+       */
+      constexpr std::string_view name() const
+      {
+         return name_;
+      }
+
+      /**
+       * @brief Make a category inherit the level of its ancestors again.
+       * @param name Name of the category.
+       */
+      static void resetLevel(std::string_view name);
+
+      /**
+       * @brief Set the level of a category and of its descendants that have no level of their own.
+       * @param name Name of the category. The empty name sets the level of every category.
+       * @param level Lowest enabled level.
+       */
+      static void setLevel(std::string_view name, LogMsg::Level level);
+
+   private:
+      static constexpr unsigned      level_bits{ 8U };                        /**< Bits of a slot holding the level. */
+      static constexpr std::uint64_t level_mask{ (1ULL << level_bits) - 1U }; /**< Mask of the level in a slot. */
+      static constexpr std::uint64_t unresolved{ 0U };                        /**< Slot to resolve from the name. */
+
+      /**
+       * @brief Resolve the level of the category and store it in its slot, unless the slot is used by another one.
+       * @param level Level of the checked messages.
+       * @return true if messages of the level are enabled, false otherwise.
+       */
+      bool resolve_(LogMsg::Level level) const;
+
+      /**
+       * @brief Get the level of a category name from the levels set so far. Called with mtx_ held.
+       * @param name Name of the category.
+       * @return Lowest enabled level.
+       */
+      static LogMsg::Level inherited_(std::string_view name);
+
+      /**
+       * @brief Mark every slot as unresolved, after a change of level. Called with mtx_ held.
+       */
+      static void invalidate_();
+
+      /**
+       * @brief Owner bits of the category of each slot, ORed with its level + 1, or unresolved.
+       */
+      static std::array<std::atomic<std::uint64_t>, table_size> levels_;
+
+      static std::vector<std::pair<std::string, LogMsg::Level>> rules_; /**< Levels set on category names. */
+      static std::mutex                                         mtx_;   /**< Mutex protecting the levels. */
+
+      std::string_view name_;  /**< Name of the category. */
+      std::uint64_t    id_;    /**< Hash of the name. */
+      size_t           slot_;  /**< Slot of the category in the table of levels. */
+      std::uint64_t    owner_; /**< Bits of the id not given by the slot, stored above the level in the slot. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_LOGCATEGORY_HPP
@@ -0,0 +1,150 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "LogClock.hpp"
+
+#include <ctime>
+#include <limits>
+#include <thread>
+
+#if defined(__x86_64__)
+   #include <cpuid.h>
+#endif
+
+namespace cjm::io
+{
+   /********** STATIC VARIABLES DEFINITIONS **********/
+   std::atomic<std::uint64_t> LogClock::version_{ 0U };
+   std::atomic<std::uint64_t> LogClock::tscBase_{ 0U };
+   std::atomic<std::int64_t>  LogClock::base_{ 0 };
+   std::atomic<std::uint64_t> LogClock::multiplier_{ 0U };
+   std::mutex                 LogClock::mtx_;
+
+   /********** METHOD DEFINITIONS **********/
+   bool LogClock::calibrate()
+   {
+#if defined(__x86_64__)
+      // The TSC only works as a clock if it ticks at a constant rate in every power state.
+      unsigned int eax{ 0U };
+      unsigned int ebx{ 0U };
+      unsigned int ecx{ 0U };
+      unsigned int edx{ 0U };
+      if (__get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx) == 0 || (edx & (1U << 8U)) == 0U)
+      {
+         publish_(0U, 0, 0U);
+         return false;
+      }
+
+      std::int64_t  startTime{ 0 };
+      std::uint64_t startTicks{ 0U };
+      sample_(startTime, startTicks);
+      std::this_thread::sleep_for(calibration_time);
+      std::int64_t  endTime{ 0 };
+      std::uint64_t endTicks{ 0U };
+      sample_(endTime, endTicks);
+      // The elapsed time is shifted in 64 bits, which holds a few seconds: far more than calibration_time.
+      auto elapsed{ static_cast<std::uint64_t>(endTime - startTime) };
+      if (endTicks <= startTicks || endTime <= startTime || (elapsed >> (64U - shift)) != 0U)
+      {
+         publish_(0U, 0, 0U);
+         return false;
+      }
+
+      publish_(endTicks, endTime, (elapsed << shift) / (endTicks - startTicks));
+      return true;
+#else
+      return false;
+#endif
+   }
+
+   bool LogClock::usingTsc()
+   {
+      return multiplier_.load(std::memory_order_relaxed) != 0U;
+   }
+
+   void LogClock::publish_(std::uint64_t tscBase, std::int64_t base, std::uint64_t multiplier)
+   {
+      std::scoped_lock lck{ mtx_ };
+
+      // Readers retry while the version is odd or changed, so they never mix values of two calibrations.
+      std::uint64_t version{ version_.load(std::memory_order_relaxed) };
+      version_.store(version + 1U, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      tscBase_.store(tscBase, std::memory_order_relaxed);
+      base_.store(base, std::memory_order_relaxed);
+      multiplier_.store(multiplier, std::memory_order_relaxed);
+      version_.store(version + 2U, std::memory_order_release);
+   }
+
+#if defined(__x86_64__)
+   void LogClock::sample_(std::int64_t& time, std::uint64_t& ticks)
+   {
+      // Keep the reading that took the fewest ticks, it is the least likely to have been interrupted.
+      std::uint64_t shortest{ std::numeric_limits<std::uint64_t>::max() };
+      for (int i = 0; i < 8; ++i)
+      {
+         std::uint64_t before{ __rdtsc() };
+         std::int64_t  reading{ system_() };
+         std::uint64_t after{ __rdtsc() };
+         if (after - before < shortest)
+         {
+            shortest = after - before;
+            time = reading;
+            ticks = before + (after - before) / 2U;
+         }
+      }
+   }
+#endif
+
+   std::int64_t LogClock::system_()
+   {
+#ifdef __linux__
+      timespec time{};
+      clock_gettime(CLOCK_MONOTONIC, &time);
+      return static_cast<std::int64_t>(time.tv_sec) * WallClock::ns_per_second + time.tv_nsec;
+#else
+      auto elapsed{ std::chrono::steady_clock::now().time_since_epoch() };
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+#endif
+   }
+
+   void WallClock::update_(std::int64_t time)
+   {
+      auto system{ std::chrono::system_clock::now().time_since_epoch() };
+      offset_ = std::chrono::duration_cast<std::chrono::nanoseconds>(system).count() - LogClock::now();
+
+      std::int64_t wall{ time + offset_ };
+      second_ = wall / ns_per_second * ns_per_second;
+      if (second_ > wall) second_ -= ns_per_second;
+
+      std::time_t seconds{ static_cast<std::time_t>(second_ / ns_per_second) };
+      std::tm     local{};
+#ifdef _WIN32
+      localtime_s(&local, &seconds);
+#else
+      localtime_r(&seconds, &local);
+#endif
+      size_ = std::strftime(text_.data(), text_.size(), "%Y-%m-%d %H:%M:%S", &local);
+   }
+} // namespace cjm::io
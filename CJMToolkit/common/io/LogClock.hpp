@@ -0,0 +1,188 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_LOGCLOCK_HPP
+#define COMMON_IO_LOGCLOCK_HPP
+
+#include "common/format/Format.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#if defined(__x86_64__)
+   #include <x86intrin.h>
+#endif
+
+namespace cjm::io
+{
+   /**
+    * @brief Clock of the logging timestamps, with nanosecond resolution.
+    * @details On x86-64 processors with an invariant TSC, readings are computed from the TSC, calibrated against
+    *          CLOCK_MONOTONIC, which costs a few nanoseconds and no system call. Elsewhere, or until calibrate
+    *          succeeds, the clock falls back to clock_gettime(CLOCK_MONOTONIC), or to std::chrono::steady_clock outside
+    *          Linux. Readings are nanoseconds on the time base of the fallback clock, so both sources can be mixed.
+    *          The calibration is published with a sequence counter, so the clock can be recalibrated while other
+    *          threads read it: a reader that overlaps an update reads the calibration again.
+    */
+   class LogClock
+   {
+   public:
+      static constexpr std::chrono::milliseconds calibration_time{ 20 }; /**< Duration of the calibration. */
+
+      /**
+       * @brief Measure the frequency of the TSC and start using it, if it is invariant.
+       * @details Blocks for calibration_time. Later calls recalibrate the clock, even while it is being read.
+       * @return true if the TSC is used, false if the clock falls back to the system clock.
+       */
+      static bool calibrate();
+
+      /**
+       * @brief Read the clock.
+       * @return Current time [ns].
+       */
+      static std::int64_t now()
+      {
+#if defined(__x86_64__)
+         while (true)
+         {
+            std::uint64_t version{ version_.load(std::memory_order_acquire) };
+            std::uint64_t multiplier{ multiplier_.load(std::memory_order_relaxed) };
+            std::uint64_t tscBase{ tscBase_.load(std::memory_order_relaxed) };
+            std::int64_t  base{ base_.load(std::memory_order_relaxed) };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((version & 1U) != 0U || version != version_.load(std::memory_order_relaxed)) continue;
+
+            if (multiplier == 0U) break;
+            return base + scale_(static_cast<std::int64_t>(__rdtsc() - tscBase), multiplier);
+         }
+#endif
+         return system_();
+      }
+
+      /**
+       * @brief Check whether the clock reads the TSC.
+       * @return true or false.
+       */
+      static bool usingTsc();
+
+   private:
+      static constexpr unsigned      shift{ 32U };                     /**< Fractional bits of the multiplier. */
+      static constexpr std::uint64_t low_mask{ (1ULL << shift) - 1U }; /**< Mask of the bits below shift. */
+
+      /**
+       * @brief Convert TSC ticks into nanoseconds, without a 128-bit type.
+       * @param ticks Ticks since the calibration, negative if the TSC of this core lags behind.
+       * @param multiplier Nanoseconds per tick, with shift fractional bits.
+       * @return Nanoseconds since the calibration.
+       */
+      static std::int64_t scale_(std::int64_t ticks, std::uint64_t multiplier)
+      {
+         // (ticks * multiplier) >> shift from 32-bit halves, each partial product fits in 64 bits.
+         std::uint64_t magnitude{ static_cast<std::uint64_t>(ticks) };
+         if (ticks < 0) magnitude = 0U - magnitude;
+         std::uint64_t high{ magnitude >> shift };
+         std::uint64_t low{ magnitude & low_mask };
+         std::uint64_t scaled{ ((high * (multiplier >> shift)) << shift) + high * (multiplier & low_mask) +
+                               low * (multiplier >> shift) + ((low * (multiplier & low_mask)) >> shift) };
+         return ticks < 0 ? -static_cast<std::int64_t>(scaled) : static_cast<std::int64_t>(scaled);
+      }
+
+      /**
+       * @brief Publish a new calibration.
+       * @param tscBase TSC at the calibration.
+       * @param base Time at the calibration [ns].
+       * @param multiplier Nanoseconds per tick, with shift fractional bits, or 0 to read the fallback clock.
+       */
+      static void publish_(std::uint64_t tscBase, std::int64_t base, std::uint64_t multiplier);
+
+      /**
+       * @brief Read the fallback clock.
+       * @return Current time [ns].
+       */
+      static std::int64_t system_();
+
+#if defined(__x86_64__)
+      /**
+       * @brief Read the fallback clock and the TSC at the same moment, as closely as possible.
+       * @param time Reading of the fallback clock [ns].
+       * @param ticks Reading of the TSC.
+       */
+      static void sample_(std::int64_t& time, std::uint64_t& ticks);
+#endif
+
+      static std::atomic<std::uint64_t> version_;    /**< Odd while a calibration is being published. */
+      static std::atomic<std::uint64_t> tscBase_;    /**< TSC at the calibration. */
+      static std::atomic<std::int64_t>  base_;       /**< Time at the calibration [ns]. */
+      static std::atomic<std::uint64_t> multiplier_; /**< Nanoseconds per tick, with shift fractional bits, or 0. */
+      static std::mutex                 mtx_;        /**< Mutex serialising the calibrations. */
+   };
+
+   /**
+    * @brief Renders clock readings as local date and time, recomputing the date and time only once per second.
+    * @details Each instance keeps its own cache and must only be used by one thread at a time.
+    */
+   class WallClock
+   {
+   public:
+      static constexpr std::int64_t ns_per_second{ 1000000000 }; /**< Nanoseconds in a second. */
+
+      /**
+       * @brief Write a clock reading as local date and time, with nanoseconds: YYYY-MM-DD hh:mm:ss.nnnnnnnnn.
+       * @tparam Output Type of the output.
+       * @param output Destination of the text.
+       * @param time Reading of LogClock [ns].
+       */
+      template<typename Output>
+      void write(Output& output, std::int64_t time)
+      {
+         std::int64_t wall{ time + offset_ };
+         if (size_ == 0U || wall < second_ || wall >= second_ + ns_per_second)
+         {
+            update_(time);
+            wall = time + offset_;
+         }
+
+         cjm::fmt::write(output, std::string_view(text_.data(), size_));
+         cjm::fmt::write(output, ".");
+         cjm::fmt::writeZeroPadded(output, static_cast<std::uint64_t>(wall - second_), 9U);
+      }
+
+   private:
+      /**
+       * @brief Measure again the offset between LogClock and the system time, and render the second of a reading.
+       * @param time Reading of LogClock [ns].
+       */
+      void update_(std::int64_t time);
+
+      std::int64_t         offset_{ 0 };  /**< System time minus LogClock time [ns]. */
+      std::int64_t         second_{ -1 }; /**< Start of the cached second, in system time [ns]. */
+      std::array<char, 32> text_{};       /**< Cached date and time. */
+      size_t               size_{ 0U };   /**< Size of the cached date and time. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_LOGCLOCK_HPP
@@ -0,0 +1,463 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "LogFilter.hpp"
+
+#include "common/data/BinaryLog.hpp"
+
+#include <array>
+#include <cctype>
+#include <charconv>
+
+namespace cjm::io
+{
+   using cjm::data::BinaryLog;
+   using cjm::data::LogMsg;
+
+   namespace
+   {
+      /**
+       * @brief Convert a whole text into a number.
+       * @param text Text to convert.
+       * @param number Converted number.
+       * @return true if the whole text is a number, false otherwise.
+       */
+      bool parseNumber(std::string_view text, double& number)
+      {
+         if (text.empty()) return false;
+
+         auto result{ std::from_chars(text.data(), text.data() + text.size(), number) };
+         return result.ec == std::errc() && result.ptr == text.data() + text.size();
+      }
+   } // namespace
+
+   /**
+    * @brief Recursive descent parser that compiles an expression into a filter program.
+    */
+   class LogFilter::Parser
+   {
+   public:
+      /**
+       * @brief Constructor.
+       * @param expression Expression to compile.
+       * @param program Destination of the instructions.
+       */
+      Parser(std::string_view expression, std::vector<Instruction>& program) :
+         expression_{ expression }, program_{ program }
+      {
+      }
+
+      /**
+       * @brief Compile the whole expression.
+       * @return true on success, false on a syntax error.
+       */
+      bool parse()
+      {
+         skipSpaces_();
+         if (offset_ == expression_.size()) return true;
+         if (!parseOr_()) return false;
+
+         skipSpaces_();
+         return offset_ == expression_.size();
+      }
+
+      /**
+       * @brief Get the position of the parser, which is the position of the error after a failure.
+       * @return Offset in the expression.
+       */
+      size_t offset() const
+      {
+         return offset_;
+      }
+
+   private:
+      /**
+       * @brief Consume a token if it comes next.
+       * @param token Expected token.
+       * @return true if the token was consumed, false otherwise.
+       */
+      bool accept_(std::string_view token)
+      {
+         skipSpaces_();
+         if (expression_.compare(offset_, token.size(), token) != 0) return false;
+
+         offset_ += token.size();
+         return true;
+      }
+
+      /**
+       * @brief Emit a jump whose target is set once the operand it skips is compiled.
+       * @param opcode Type of jump.
+       * @return Index of the jump.
+       */
+      size_t emitJump_(Opcode opcode)
+      {
+         Instruction jump;
+         jump.opcode = opcode;
+         program_.push_back(std::move(jump));
+         return program_.size() - 1U;
+      }
+
+      /**
+       * @brief Compile a sequence of operands separated by a logical operator.
+       * @param token Logical operator.
+       * @param jump Jump taken when the result is already known.
+       * @param parseOperand Function that compiles an operand.
+       * @return true on success, false on a syntax error.
+       */
+      bool parseChain_(std::string_view token, Opcode jump, bool (Parser::*parseOperand)())
+      {
+         if (!(this->*parseOperand)()) return false;
+
+         std::vector<size_t> jumps;
+         while (accept_(token))
+         {
+            jumps.push_back(emitJump_(jump));
+            if (!(this->*parseOperand)()) return false;
+         }
+         for (size_t index : jumps)
+         {
+            program_[index].target = program_.size();
+         }
+         return true;
+      }
+
+      /**
+       * @brief Compile a comparison operator, if one comes next.
+       * @param comparison Parsed comparison.
+       * @return true if an operator was consumed, false otherwise.
+       */
+      bool parseComparison_(Comparison& comparison)
+      {
+         // Two-character operators come first, so that < does not hide <=.
+         constexpr std::array<std::pair<std::string_view, Comparison>, 7> operators{ {
+            { "==", Comparison::equal },
+            { "!=", Comparison::not_equal },
+            { "<=", Comparison::less_equal },
+            { ">=", Comparison::greater_equal },
+            { "<", Comparison::less },
+            { ">", Comparison::greater },
+            { "~", Comparison::contains },
+         } };
+         for (const auto& [token, value] : operators)
+         {
+            if (accept_(token))
+            {
+               comparison = value;
+               return true;
+            }
+         }
+         return false;
+      }
+
+      /**
+       * @brief Compile operands separated by &&.
+       */
+      bool parseAnd_()
+      {
+         return parseChain_("&&", Opcode::jump_if_false, &Parser::parseUnary_);
+      }
+
+      /**
+       * @brief Compile operands separated by ||.
+       */
+      bool parseOr_()
+      {
+         return parseChain_("||", Opcode::jump_if_true, &Parser::parseAnd_);
+      }
+
+      /**
+       * @brief Compile a quoted string. Backslashes escape the next character.
+       * @param text Parsed string.
+       * @return true on success, false on a syntax error.
+       */
+      bool parseString_(std::string& text)
+      {
+         if (!accept_("\"")) return false;
+
+         text.clear();
+         while (offset_ < expression_.size() && expression_[offset_] != '"')
+         {
+            if (expression_[offset_] == '\\' && offset_ + 1U < expression_.size()) ++offset_;
+            text += expression_[offset_++];
+         }
+         return accept_("\"");
+      }
+
+      /**
+       * @brief Compile a term: a comparison of the level, of the message text or of a datagram.
+       * @return true on success, false on a syntax error.
+       */
+      bool parseTerm_()
+      {
+         Instruction term;
+         std::string name;
+         skipSpaces_();
+         size_t start{ offset_ };
+         if (!parseWord_(name)) return false;
+
+         if (name == "level")
+         {
+            term.opcode = Opcode::level;
+            if (!parseComparison_(term.comparison) || term.comparison == Comparison::contains) return false;
+
+            skipSpaces_();
+            if (!parseWord_(term.text) || !LogMsg::parseLevel(term.text, term.level)) return false;
+         }
+         else if (name == "msg")
+         {
+            term.opcode = Opcode::message;
+            if (!parseComparison_(term.comparison) || !parseString_(term.text)) return false;
+         }
+         else if (name == "key")
+         {
+            term.opcode = Opcode::key;
+            if (!accept_("(") || !parseString_(term.key) || !accept_(")")) return false;
+            term.keyId = BinaryLog::intern(term.key);
+
+            // Without a comparison, the term checks that the datagram exists.
+            if (parseComparison_(term.comparison))
+            {
+               skipSpaces_();
+               if (!parseString_(term.text) && !parseWord_(term.text)) return false;
+            }
+         }
+         else
+         {
+            offset_ = start;
+            return false;
+         }
+
+         term.numeric = parseNumber(term.text, term.number);
+         program_.push_back(std::move(term));
+         return true;
+      }
+
+      /**
+       * @brief Compile a negation, a parenthesised expression or a term.
+       * @return true on success, false on a syntax error.
+       */
+      bool parseUnary_()
+      {
+         if (accept_("!"))
+         {
+            if (!parseUnary_()) return false;
+
+            Instruction negation;
+            negation.opcode = Opcode::negate;
+            program_.push_back(std::move(negation));
+            return true;
+         }
+         if (accept_("("))
+         {
+            return parseOr_() && accept_(")");
+         }
+         return parseTerm_();
+      }
+
+      /**
+       * @brief Compile a word: a name, a level or a number without quotes.
+       * @param word Parsed word.
+       * @return true if the word is not empty, false otherwise.
+       */
+      bool parseWord_(std::string& word)
+      {
+         size_t start{ offset_ };
+         while (offset_ < expression_.size())
+         {
+            char character{ expression_[offset_] };
+            if (!std::isalnum(static_cast<unsigned char>(character)) && character != '_' && character != '.' &&
+                character != '-' && character != '+')
+            {
+               break;
+            }
+            ++offset_;
+         }
+         word.assign(expression_.substr(start, offset_ - start));
+         return !word.empty();
+      }
+
+      /**
+       * @brief Skip white spaces.
+       */
+      void skipSpaces_()
+      {
+         while (offset_ < expression_.size() && std::isspace(static_cast<unsigned char>(expression_[offset_])))
+         {
+            ++offset_;
+         }
+      }
+
+      std::string_view          expression_;   /**< Expression to compile. */
+      std::vector<Instruction>& program_;      /**< Destination of the instructions. */
+      size_t                    offset_{ 0U }; /**< Position in the expression. */
+   };
+
+   /********** METHOD DEFINITIONS **********/
+   bool LogFilter::accepts(const LogMsg& message) const
+   {
+      if (program_.empty()) return true;
+
+      return evaluate_(Record{ message.level(), message.message(), &message, &findDatagram_ });
+   }
+
+   bool LogFilter::compile(std::string_view expression)
+   {
+      std::vector<Instruction> program;
+      Parser                   parser{ expression, program };
+      bool                     compiled{ parser.parse() };
+      errorOffset_ = parser.offset();
+      if (!compiled)
+      {
+         program_.clear();
+         expression_.clear();
+         return false;
+      }
+
+      program_ = std::move(program);
+      expression_ = expression;
+      return true;
+   }
+
+   bool LogFilter::empty() const
+   {
+      return program_.empty();
+   }
+
+   size_t LogFilter::errorOffset() const
+   {
+      return errorOffset_;
+   }
+
+   const std::string& LogFilter::expression() const
+   {
+      return expression_;
+   }
+
+   bool LogFilter::evaluate_(const Record& record) const
+   {
+      // Datagrams are formatted into a buffer of the thread, which keeps its capacity across records.
+      thread_local std::string buffer;
+      bool                     result{ true };
+      for (size_t i = 0U; i < program_.size(); ++i)
+      {
+         const Instruction& instruction{ program_[i] };
+         switch (instruction.opcode)
+         {
+         case Opcode::level:
+            result = holds_(
+               instruction.comparison, static_cast<int>(record.level) - static_cast<int>(instruction.level));
+            break;
+         case Opcode::message:
+            result = matches_(instruction, record.message);
+            break;
+         case Opcode::key:
+         {
+            std::string_view value;
+            result = record.find(record.data, instruction, buffer, value) && matches_(instruction, value);
+            break;
+         }
+         case Opcode::negate:
+            result = !result;
+            break;
+         case Opcode::jump_if_false:
+            if (!result) i = instruction.target - 1U;
+            break;
+         case Opcode::jump_if_true:
+            if (result) i = instruction.target - 1U;
+            break;
+         }
+      }
+      return result;
+   }
+
+   bool LogFilter::findDatagram_(
+      const void* data, const Instruction& instruction, std::string& buffer, std::string_view& value)
+   {
+      const LogMsg& message{ *static_cast<const LogMsg*>(data) };
+      bool          found{ false };
+      if (message.binary())
+      {
+         // Literal descriptions are interned, comparing their ids avoids looking up their text.
+         BinaryLog::visitData(message.payload(), [&](const BinaryLog::Field& field) {
+            if (found) return;
+            if (field.descriptionId == BinaryLog::no_id ? field.description != instruction.key
+                                                        : field.descriptionId != instruction.keyId)
+               return;
+
+            buffer.assign(field.value);
+            found = true;
+         });
+         value = buffer;
+         return found;
+      }
+
+      message.forEachData([&](std::string_view description, std::string_view text) {
+         if (found || description != instruction.key) return;
+
+         value = text;
+         found = true;
+      });
+      return found;
+   }
+
+   bool LogFilter::holds_(Comparison comparison, int order)
+   {
+      switch (comparison)
+      {
+      case Comparison::equal:
+         return order == 0;
+      case Comparison::not_equal:
+         return order != 0;
+      case Comparison::less:
+         return order < 0;
+      case Comparison::less_equal:
+         return order <= 0;
+      case Comparison::greater:
+         return order > 0;
+      case Comparison::greater_equal:
+         return order >= 0;
+      default:
+         return false;
+      }
+   }
+   bool LogFilter::matches_(const Instruction& instruction, std::string_view value)
+   {
+      if (instruction.comparison == Comparison::exists) return true;
+      if (instruction.comparison == Comparison::contains) return value.find(instruction.text) != std::string_view::npos;
+
+      int    order{ 0 };
+      double number{ 0.0 };
+      if (instruction.numeric && parseNumber(value, number))
+      {
+         order = number < instruction.number ? -1 : (number > instruction.number ? 1 : 0);
+      }
+      else
+      {
+         order = value.compare(instruction.text);
+      }
+      return holds_(instruction.comparison, order);
+   }
+
+} // namespace cjm::io
@@ -0,0 +1,236 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_LOGFILTER_HPP
+#define COMMON_IO_LOGFILTER_HPP
+
+#include "common/data/LogMsg.hpp"
+#include "common/format/Format.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace cjm::io
+{
+   /**
+    * @brief Predicate on log records, compiled once from an expression such as
+    *        level>=warn && msg~"Node" && key("node name")=="Size".
+    * @details Terms compare the level with a level name, the text of the message with a string, or a datagram with a
+    *          string, a number or a word. The operators are ==, !=, <, <=, >, >= and ~, which checks that the text
+    *          contains the string. key("name") alone checks that the datagram exists, and a missing datagram fails
+    *          every comparison. Datagrams compare as numbers if both sides are numbers, as text otherwise. Terms are
+    *          combined with !, && and ||, with parentheses. The expression is compiled into a flat program with one
+    *          result register, where && and || jump over the terms they do not need, so datagrams are only looked up
+    *          when their term is reached. An empty filter accepts every record.
+    */
+   class LogFilter
+   {
+   public:
+      using LogMsg = cjm::data::LogMsg;
+
+      /**
+       * @brief Default constructor. The filter accepts every record.
+       */
+      LogFilter() = default;
+
+      /**
+       * @brief Check whether the filter accepts a message.
+       * @param message Message to check.
+       * @return true or false.
+       */
+      bool accepts(const LogMsg& message) const;
+
+      /**
+       * @brief Check whether the filter accepts a record that is not built yet, formatting only the data it compares.
+       * @param level Level of the record.
+       * @param message Text of the record.
+       * @param args Data of the record. Should be pairs (description, variable).
+       * @return true or false.
+       */
+      template<typename... Args>
+      bool accepts(LogMsg::Level level, std::string_view message, const Args&... args) const
+      {
+         if (program_.empty()) return true;
+
+         std::tuple<const Args&...> data{ args... };
+         return evaluate_(Record{ level, message, &data, &findArgument_<Args...> });
+      }
+
+      /**
+       * @brief Compile an expression, replacing the current program.
+       * @param expression Filter expression. An empty expression accepts every record.
+       * @return true on success, false on a syntax error, in which case the filter accepts every record.
+       */
+      bool compile(std::string_view expression);
+
+      /**
+       * @brief Check whether the filter accepts every record.
+       * @return true or false.
+       */
+      bool empty() const;
+
+      /**
+       * @brief Get the position of the syntax error found by the last compilation.
+       * @return Offset in the expression.
+       */
+      size_t errorOffset() const;
+
+      /**
+       * @brief Get the compiled expression.
+       * @return Expression of the filter.
+       */
+      const std::string& expression() const;
+
+   private:
+      /**
+       * @brief Operations of a filter program.
+       */
+      enum class Opcode : std::uint8_t
+      {
+         level,         /**< Compare the level of the record. */
+         message,       /**< Compare the text of the record. */
+         key,           /**< Compare a datagram of the record. */
+         negate,        /**< Negate the result. */
+         jump_if_false, /**< Continue at the target if the result is false. */
+         jump_if_true   /**< Continue at the target if the result is true. */
+      };
+
+      /**
+       * @brief Comparisons of a term.
+       */
+      enum class Comparison : std::uint8_t
+      {
+         exists,        /**< The datagram exists. */
+         equal,         /**< ==. */
+         not_equal,     /**< !=. */
+         less,          /**< <. */
+         less_equal,    /**< <=. */
+         greater,       /**< >. */
+         greater_equal, /**< >=. */
+         contains       /**< ~. */
+      };
+
+      /**
+       * @brief Instruction of a filter program.
+       */
+      struct Instruction
+      {
+         Opcode        opcode{ Opcode::negate };         /**< Operation. */
+         Comparison    comparison{ Comparison::exists }; /**< Comparison of a term. */
+         LogMsg::Level level{ LogMsg::Level::trace };    /**< Level compared by a level term. */
+         std::string   key;                              /**< Description of the datagram compared by a key term. */
+         std::uint32_t keyId{ 0U };                      /**< Interned id of the description, for binary messages. */
+         std::string   text;                             /**< Text compared by a term. */
+         double        number{ 0.0 };                    /**< Text as a number. */
+         bool          numeric{ false };                 /**< true if the text is a number. */
+         size_t        target{ 0U };                     /**< Instruction a jump continues at. */
+      };
+
+      /**
+       * @brief Function that looks up a datagram of a record.
+       * @param data Data of the record.
+       * @param instruction Key term, with the description of the datagram.
+       * @param buffer Storage for values that have to be formatted or copied.
+       * @param value Value of the datagram.
+       * @return true if the datagram exists, false otherwise.
+       */
+      using Finder = bool (*)(
+         const void* data, const Instruction& instruction, std::string& buffer, std::string_view& value);
+
+      /**
+       * @brief Record seen by a filter program.
+       */
+      struct Record
+      {
+         LogMsg::Level    level;   /**< Level of the record. */
+         std::string_view message; /**< Text of the record. */
+         const void*      data;    /**< Data of the record, read by find. */
+         Finder           find;    /**< Function that looks up a datagram. */
+      };
+
+      class Parser;
+
+      /**
+       * @brief Run the program on a record.
+       * @param record Record to check.
+       * @return true if the record is accepted, false otherwise.
+       */
+      bool evaluate_(const Record& record) const;
+
+      /**
+       * @brief Look up a datagram in the arguments of a record that is not built yet.
+       * @tparam Args Types of the arguments.
+       */
+      template<typename... Args>
+      static bool
+         findArgument_(const void* data, const Instruction& instruction, std::string& buffer, std::string_view& value)
+      {
+         bool found{ false };
+         auto find = [&](const auto& arg) {
+            if (found || std::string_view(arg.first) != instruction.key) return;
+
+            buffer.clear();
+            cjm::fmt::StringOutput output{ buffer };
+            cjm::fmt::format(output, arg.second);
+            value = buffer;
+            found = true;
+         };
+         const auto& arguments{ *static_cast<const std::tuple<const Args&...>*>(data) };
+         std::apply([&find](const auto&... args) { (find(args), ...); }, arguments);
+         return found;
+      }
+
+      /**
+       * @brief Look up a datagram in a message.
+       */
+      static bool
+         findDatagram_(const void* data, const Instruction& instruction, std::string& buffer, std::string_view& value);
+
+      /**
+       * @brief Check whether a comparison holds.
+       * @param comparison Comparison of a term.
+       * @param order Negative, zero or positive if the compared value is less than, equal to or greater than the one
+       *              of the term.
+       * @return true or false.
+       */
+      static bool holds_(Comparison comparison, int order);
+
+      /**
+       * @brief Compare a text with the text of a term.
+       * @param instruction Term.
+       * @param value Text to compare.
+       * @return Result of the comparison.
+       */
+      static bool matches_(const Instruction& instruction, std::string_view value);
+
+      std::vector<Instruction> program_;           /**< Compiled expression. */
+      std::string              expression_;        /**< Source of the program. */
+      size_t                   errorOffset_{ 0U }; /**< Position of the last syntax error. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_LOGFILTER_HPP
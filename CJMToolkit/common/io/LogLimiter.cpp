@@ -0,0 +1,169 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "LogLimiter.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace cjm::io
+{
+   bool LogLimiter::admit(const LogSite& site, std::string_view message, Repeats& repeats)
+   {
+      repeats.count = 0U;
+
+      std::uint32_t rate{ rate_.load(std::memory_order_relaxed) };
+      if (rate == 0U || site.level() >= LogMsg::Level::error) return true;
+
+      std::uint64_t     key{ hash_(site, message) };
+      Clock::time_point now{ Clock::now() };
+      auto              burst{ static_cast<double>(burst_.load(std::memory_order_relaxed)) };
+      // A new key takes the first freed slot, but only once the key is known not to be stored further.
+      size_t freed{ slot_count };
+      for (size_t probe = 0U; probe < max_probes; ++probe)
+      {
+         size_t           index{ static_cast<size_t>((key + probe) % slot_count) };
+         std::scoped_lock lck{ locks_[index % lock_count] };
+         Slot&            slot{ slots_[index] };
+         if (slot.key == freed_key)
+         {
+            if (freed == slot_count) freed = index;
+            continue;
+         }
+         if (slot.key == 0U)
+         {
+            if (freed != slot_count) break;
+            claim_(slot, key, site, message, burst, now);
+         }
+         else if (slot.key != key)
+         {
+            continue;
+         }
+
+         return consume_(slot, rate, burst, now, repeats);
+      }
+
+      if (freed != slot_count)
+      {
+         std::scoped_lock lck{ locks_[freed % lock_count] };
+         Slot&            slot{ slots_[freed] };
+         if (slot.key == freed_key) claim_(slot, key, site, message, burst, now);
+
+         // Another thread may have taken the slot in the meantime, for another key.
+         if (slot.key == key) return consume_(slot, rate, burst, now, repeats);
+      }
+
+      // The neighbourhood of the key is full: do not limit it.
+      return true;
+   }
+
+   std::uint32_t LogLimiter::burst() const
+   {
+      return burst_.load(std::memory_order_relaxed);
+   }
+
+   std::uint32_t LogLimiter::rate() const
+   {
+      return rate_.load(std::memory_order_relaxed);
+   }
+
+   void LogLimiter::setRate(std::uint32_t rate, std::uint32_t burst)
+   {
+      rate_.store(rate, std::memory_order_relaxed);
+      burst_.store(burst > 0U ? burst : 1U, std::memory_order_relaxed);
+   }
+
+   void LogLimiter::claim_(
+      Slot& slot, std::uint64_t key, const LogSite& site, std::string_view message, double burst, Clock::time_point now)
+   {
+      slot.key = key;
+      slot.site = &site;
+      slot.tokens = burst;
+      slot.refilled = now;
+      slot.suppressed = 0U;
+      slot.textSize = std::min(message.size(), message_size);
+      std::memcpy(slot.text.data(), message.data(), slot.textSize);
+   }
+
+   bool LogLimiter::consume_(Slot& slot, std::uint32_t rate, double burst, Clock::time_point now, Repeats& repeats)
+   {
+      std::chrono::duration<double> elapsed{ now - slot.refilled };
+      slot.tokens = std::min(burst, slot.tokens + elapsed.count() * rate);
+      slot.refilled = now;
+      if (slot.tokens < 1.0)
+      {
+         if (slot.suppressed == 0U) slot.firstSuppressed = now;
+         slot.lastSuppressed = now;
+         ++slot.suppressed;
+         return false;
+      }
+
+      slot.tokens -= 1.0;
+      if (slot.suppressed > 0U) take_(slot, repeats);
+      return true;
+   }
+
+   std::uint64_t LogLimiter::hash_(const LogSite& site, std::string_view message)
+   {
+      // FNV-1a over the text, then the address of the site.
+      constexpr std::uint64_t offset_basis{ 14695981039346656037ULL };
+      constexpr std::uint64_t prime{ 1099511628211ULL };
+
+      std::uint64_t hash{ offset_basis };
+      for (char character : message)
+      {
+         hash = (hash ^ static_cast<unsigned char>(character)) * prime;
+      }
+      hash = (hash ^ reinterpret_cast<std::uintptr_t>(&site)) * prime;
+
+      return hash > freed_key ? hash : hash + freed_key + 1U;
+   }
+
+   void LogLimiter::take_(Slot& slot, Repeats& repeats)
+   {
+      repeats.site = slot.site;
+      repeats.level = slot.site->level();
+      repeats.count = slot.suppressed;
+      repeats.period =
+         std::chrono::duration_cast<std::chrono::milliseconds>(slot.lastSuppressed - slot.firstSuppressed);
+      repeats.textSize = slot.textSize;
+      std::memcpy(repeats.text.data(), slot.text.data(), slot.textSize);
+      slot.suppressed = 0U;
+   }
+
+   bool LogLimiter::takeEnded_(Slot& slot, Clock::time_point now, bool all, Repeats& repeats)
+   {
+      if (slot.key == 0U || slot.key == freed_key) return false;
+
+      if (slot.suppressed > 0U && (all || now - slot.lastSuppressed >= quiet_period))
+      {
+         take_(slot, repeats);
+         return true;
+      }
+      if (slot.suppressed == 0U && now - slot.refilled >= idle_timeout) slot.key = freed_key;
+
+      return false;
+   }
+} // namespace cjm::io
@@ -0,0 +1,211 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_LOGLIMITER_HPP
+#define COMMON_IO_LOGLIMITER_HPP
+
+#include "LogSite.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+namespace cjm::io
+{
+   /**
+    * @brief Suppression of repeated messages, with a token bucket for each message and call site.
+    * @details Each key may log a burst of messages, then as many messages per second as the rate allows. Suppressed
+    *          messages are counted, and the count is handed back once the key logs again or stays quiet for
+    *          quiet_period, so that a single "repeated N times in T ms" line can be written.
+    *          Keys are a hash of the message text and the address of the site, kept in a fixed table: looking them up
+    *          never allocates. When the table is full, new keys are not limited. Error and fatal messages are never
+    *          suppressed.
+    */
+   class LogLimiter
+   {
+   public:
+      using Clock = std::chrono::steady_clock;
+      using LogMsg = cjm::data::LogMsg;
+
+      static constexpr size_t                    slot_count{ 1024U };  /**< Number of keys in the table. */
+      static constexpr size_t                    max_probes{ 8U };     /**< Slots tried for each key. */
+      static constexpr size_t                    lock_count{ 64U };    /**< Number of mutexes guarding the slots. */
+      static constexpr size_t                    message_size{ 128U }; /**< Characters of a message kept for reports. */
+      static constexpr std::chrono::milliseconds quiet_period{ 1000 }; /**< Time without repeats ending a burst. */
+      static constexpr std::chrono::seconds      idle_timeout{ 60 };   /**< Time after which an idle key is freed. */
+      static constexpr std::uint32_t             default_rate{ 10U };  /**< Default messages per second per key. */
+      static constexpr std::uint32_t             default_burst{ 50U }; /**< Default burst per key. */
+
+      /**
+       * @brief Messages of a key suppressed during a burst.
+       */
+      struct Repeats
+      {
+         const LogSite*                 site{ nullptr };               /**< Site of the messages. */
+         LogMsg::Level                  level{ LogMsg::Level::trace }; /**< Level of the messages. */
+         std::uint64_t                  count{ 0U };                   /**< Number of suppressed messages. */
+         std::chrono::milliseconds      period{ 0 };                   /**< Duration of the burst. */
+         std::array<char, message_size> text;                          /**< Beginning of the message text. */
+         size_t                         textSize{ 0U };                /**< Size of the kept text. */
+
+         /**
+          * @brief Get the text of the message.
+          * @return Beginning of the message text.
+          */
+         std::string_view message() const
+         {
+            return std::string_view(text.data(), textSize);
+         }
+      };
+
+      /**
+       * @brief Check whether a message may be logged.
+       * @param site Site of the call.
+       * @param message Text of the message.
+       * @param repeats Filled with the messages suppressed before this one, if the message may be logged and some
+       *                were. Its count is 0 otherwise.
+       * @return true if the message may be logged, false if it is suppressed.
+       */
+      bool admit(const LogSite& site, std::string_view message, Repeats& repeats);
+
+      /**
+       * @brief Get the burst allowed for each key.
+       * @return Number of messages.
+       */
+      std::uint32_t burst() const;
+
+      /**
+       * @brief Get the rate allowed for each key.
+       * @return Messages per second, 0 if limiting is disabled.
+       */
+      std::uint32_t rate() const;
+
+      /**
+       * @brief Set the rate and burst allowed for each key.
+       * @param rate Messages per second, 0 to disable limiting.
+       * @param burst Messages that can be logged at once. 0 is treated as 1.
+       */
+      void setRate(std::uint32_t rate, std::uint32_t burst);
+
+      /**
+       * @brief Report the bursts that ended and free the keys that have been idle for long.
+       * @param report Callable invoked with a const Repeats& for each burst that ended.
+       * @param all If true, also report the bursts still going on, without waiting for their quiet period.
+       */
+      template<typename Callable>
+      void sweep(Callable report, bool all = false)
+      {
+         Repeats repeats;
+         for (size_t i = 0U; i < slot_count; ++i)
+         {
+            {
+               std::scoped_lock lck{ locks_[i % lock_count] };
+               if (!takeEnded_(slots_[i], Clock::now(), all, repeats)) continue;
+            }
+            report(static_cast<const Repeats&>(repeats));
+         }
+      }
+
+   private:
+      /**
+       * @brief Key of a slot freed after use. Lookups go on past it, since the key looked for may have been stored
+       *        further when the slot was taken.
+       */
+      static constexpr std::uint64_t freed_key{ 1U };
+
+      /**
+       * @brief Entry of the key table.
+       */
+      struct Slot
+      {
+         std::uint64_t                  key{ 0U };        /**< Hash of the key, 0 or freed_key if the slot is free. */
+         const LogSite*                 site{ nullptr };  /**< Site of the key. */
+         double                         tokens{ 0.0 };    /**< Messages that can be logged right now. */
+         Clock::time_point              refilled;         /**< Last time tokens were added. */
+         Clock::time_point              firstSuppressed;  /**< Time of the first suppressed message of the burst. */
+         Clock::time_point              lastSuppressed;   /**< Time of the last suppressed message of the burst. */
+         std::uint64_t                  suppressed{ 0U }; /**< Messages suppressed in the current burst. */
+         std::array<char, message_size> text;             /**< Beginning of the message text. */
+         size_t                         textSize{ 0U };   /**< Size of the kept text. */
+      };
+
+      /**
+       * @brief Store a new key in a free slot. Called with the lock of the slot held.
+       * @param slot Free slot.
+       * @param key Hash of the key.
+       * @param site Site of the key.
+       * @param message Text of the message.
+       * @param burst Burst allowed for each key.
+       * @param now Current time.
+       */
+      static void claim_(
+         Slot&             slot,
+         std::uint64_t     key,
+         const LogSite&    site,
+         std::string_view  message,
+         double            burst,
+         Clock::time_point now);
+
+      /**
+       * @brief Refill the tokens of a key and spend one, or count the message as suppressed. Called with the lock of
+       *        the slot held.
+       * @param slot Slot of the key.
+       * @param rate Messages per second allowed for each key.
+       * @param burst Burst allowed for each key.
+       * @param now Current time.
+       * @param repeats Messages suppressed during the burst that just ended, if the message is admitted.
+       * @return true if the message is admitted, false if it is suppressed.
+       */
+      static bool consume_(Slot& slot, std::uint32_t rate, double burst, Clock::time_point now, Repeats& repeats);
+
+      /**
+       * @brief Hash a message and its site.
+       * @return Hash that is neither 0 nor freed_key.
+       */
+      static std::uint64_t hash_(const LogSite& site, std::string_view message);
+
+      /**
+       * @brief Move the suppressed messages of a slot into a report. Called with the lock of the slot held.
+       */
+      static void take_(Slot& slot, Repeats& repeats);
+
+      /**
+       * @brief Take the suppressed messages of a slot if its burst ended, and free it if idle. Called with the lock
+       *        of the slot held.
+       * @param all If true, take the suppressed messages even if the burst is still going on.
+       * @return true if repeats were taken.
+       */
+      static bool takeEnded_(Slot& slot, Clock::time_point now, bool all, Repeats& repeats);
+
+      std::array<Slot, slot_count>       slots_;                  /**< Key table. */
+      std::array<std::mutex, lock_count> locks_;                  /**< Mutexes guarding the slots. */
+      std::atomic<std::uint32_t>         rate_{ default_rate };   /**< Messages per second per key. */
+      std::atomic<std::uint32_t>         burst_{ default_burst }; /**< Burst per key. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_LOGLIMITER_HPP
@@ -0,0 +1,201 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "LogSink.hpp"
+
+#include "Log.hpp"
+#include "common/data/BaseSettings.hpp"
+
+#include <cstdlib>
+#include <utility>
+
+namespace cjm::io
+{
+   using namespace cjm::data::log_literals;
+
+   bool LogSink::accepts(LogMsg::Level level) const
+   {
+      return level >= level_.load(std::memory_order_relaxed);
+   }
+
+   bool LogSink::accepts(const LogMsg& message) const
+   {
+      return accepts(message.level()) && filter_.accepts(message);
+   }
+
+   size_t LogSink::batchSize() const
+   {
+      return batchSize_;
+   }
+
+   bool LogSink::configure(const cjm::data::BaseSettings& settings)
+   {
+      using cjm::data::BaseSettings;
+
+      Log* logger{ Log::logger() };
+
+      BaseSettings levelSettings{ settings.enterNode(Keys::level) };
+      if (levelSettings.valid())
+      {
+         LogMsg::Level level{ LogMsg::Level::trace };
+         if (!LogMsg::parseLevel(levelSettings.value(), level))
+         {
+            logger->error("Invalid sink level."_lt, Log::pack("level"_lt, levelSettings.value()));
+            return false;
+         }
+         setLevel(level);
+      }
+
+      BaseSettings filterSettings{ settings.enterNode(Keys::filter) };
+      if (filterSettings.valid())
+      {
+         LogFilter filter;
+         if (!filter.compile(filterSettings.value()))
+         {
+            logger->error(
+               "Invalid sink filter."_lt,
+               Log::pack("filter"_lt, filterSettings.value()),
+               Log::pack("error offset"_lt, filter.errorOffset()));
+            return false;
+         }
+         setFilter(std::move(filter));
+      }
+
+      BaseSettings batchSettings{ settings.enterNode(Keys::batch_size) };
+      if (batchSettings.valid())
+      {
+         long batchSize{ std::atol(std::string(batchSettings.value()).c_str()) };
+         if (batchSize <= 0)
+         {
+            logger->error("Invalid sink batch size."_lt, Log::pack("batch size"_lt, batchSettings.value()));
+            return false;
+         }
+         setBatchSize(static_cast<size_t>(batchSize));
+      }
+
+      BaseSettings intervalSettings{ settings.enterNode(Keys::flush_interval) };
+      if (intervalSettings.valid())
+      {
+         long interval{ std::atol(std::string(intervalSettings.value()).c_str()) };
+         if (interval < 0)
+         {
+            logger->error("Invalid sink flush interval."_lt, Log::pack("flush interval"_lt, intervalSettings.value()));
+            return false;
+         }
+         setFlushInterval(std::chrono::milliseconds(interval));
+      }
+
+      return true;
+   }
+
+   const LogFilter& LogSink::filter() const
+   {
+      return filter_;
+   }
+
+   void LogSink::flush(Clock::time_point now)
+   {
+      flush_();
+      pending_ = 0U;
+      lastFlush_ = now;
+   }
+
+   std::chrono::milliseconds LogSink::flushInterval() const
+   {
+      return flushInterval_;
+   }
+
+   LogSink::LogMsg::Level LogSink::level() const
+   {
+      return level_.load(std::memory_order_relaxed);
+   }
+
+   bool LogSink::needsText() const
+   {
+      return true;
+   }
+
+   void LogSink::poll(Clock::time_point now)
+   {
+      if (pending_ > 0U && now - lastFlush_ >= flushInterval_) flush(now);
+   }
+
+   void LogSink::setBatchSize(size_t batchSize)
+   {
+      batchSize_ = batchSize > 0U ? batchSize : 1U;
+   }
+
+   void LogSink::setFilter(LogFilter filter)
+   {
+      filter_ = std::move(filter);
+   }
+
+   void LogSink::setFlushInterval(std::chrono::milliseconds flushInterval)
+   {
+      flushInterval_ = flushInterval;
+   }
+
+   void LogSink::setLevel(LogMsg::Level level)
+   {
+      level_.store(level, std::memory_order_relaxed);
+   }
+
+   bool LogSink::takeFailure(std::string& output)
+   {
+      if (!unreported_) return false;
+
+      unreported_ = false;
+      output = failedOutput_;
+      return true;
+   }
+
+   void LogSink::write(const LogMsg& message, std::string_view text, Clock::time_point now)
+   {
+      write_(message, text);
+      ++pending_;
+
+      if (pending_ >= batchSize_)
+      {
+         flush(now);
+      }
+      else
+      {
+         poll(now);
+      }
+   }
+
+   void LogSink::fail_(std::string_view output)
+   {
+      if (failed_) return;
+
+      failed_ = true;
+      unreported_ = true;
+      failedOutput_ = output;
+   }
+
+   void LogSink::recover_()
+   {
+      failed_ = false;
+   }
+} // namespace cjm::io
@@ -0,0 +1,230 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_LOGSINK_HPP
+#define COMMON_IO_LOGSINK_HPP
+
+#include "common/data/LogMsg.hpp"
+#include "common/io/LogFilter.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace cjm::data
+{
+   class BaseSettings;
+}
+
+namespace cjm::io
+{
+   /**
+    * @brief Destination of logging messages.
+    * @details Every sink has its own level threshold and filter, and flushes its output after a batch of messages or
+    *          when its flush interval expires, whichever comes first. Sinks are owned by the logger, which only calls
+    *          them from one thread at a time.
+    */
+   class LogSink
+   {
+   public:
+      using LogMsg = cjm::data::LogMsg;
+      using Clock = std::chrono::steady_clock;
+
+      /**
+       * @brief Names of the settings nodes shared by every sink.
+       */
+      struct Keys
+      {
+         static constexpr std::string_view level{ "Level" };                  /**< Level threshold. */
+         static constexpr std::string_view batch_size{ "BatchSize" };         /**< Messages between flushes. */
+         static constexpr std::string_view flush_interval{ "FlushInterval" }; /**< Time between flushes [ms]. */
+         static constexpr std::string_view filter{ "Filter" };                /**< Expression of the filter. */
+      };
+
+      static constexpr size_t                    default_batch_size{ 64U };    /**< Default batch size. */
+      static constexpr std::chrono::milliseconds default_flush_interval{ 50 }; /**< Default flush interval. */
+
+      /**
+       * @brief Default constructor.
+       */
+      LogSink() = default;
+
+      /**
+       * @brief Copy constructor.
+       */
+      LogSink(const LogSink&) = delete;
+
+      /**
+       * @brief Destructor.
+       */
+      virtual ~LogSink() = default;
+
+      /**
+       * @brief Copy-assignment operator.
+       */
+      LogSink& operator=(const LogSink&) = delete;
+
+      /**
+       * @brief Check whether the sink accepts messages of a given level.
+       * @param level Level of the message.
+       * @return true or false.
+       */
+      bool accepts(LogMsg::Level level) const;
+
+      /**
+       * @brief Check whether the sink accepts a message, with its level threshold and its filter.
+       * @param message Message to check.
+       * @return true or false.
+       */
+      bool accepts(const LogMsg& message) const;
+
+      /**
+       * @brief Get the number of messages written between two flushes.
+       * @return Batch size.
+       */
+      size_t batchSize() const;
+
+      /**
+       * @brief Load the level, filter, batch size and flush interval of the sink from its settings node.
+       * @details Missing values keep their current setting.
+       * @param settings Settings node of the sink.
+       * @return true on success, false if a value is invalid.
+       */
+      bool configure(const cjm::data::BaseSettings& settings);
+
+      /**
+       * @brief Get the filter of the sink.
+       * @return Filter applied to the messages, after the level threshold.
+       */
+      const LogFilter& filter() const;
+
+      /**
+       * @brief Flush the output of the sink.
+       * @param now Current time.
+       */
+      void flush(Clock::time_point now = Clock::now());
+
+      /**
+       * @brief Get the maximum time a written message can wait before being flushed.
+       * @return Flush interval.
+       */
+      std::chrono::milliseconds flushInterval() const;
+
+      /**
+       * @brief Get the level threshold of the sink.
+       * @return Minimum level of the messages written by the sink.
+       */
+      LogMsg::Level level() const;
+
+      /**
+       * @brief Check whether the sink uses the rendered text of the messages.
+       * @return true or false.
+       */
+      virtual bool needsText() const;
+
+      /**
+       * @brief Flush the output if the flush interval of pending messages has expired.
+       * @param now Current time.
+       */
+      void poll(Clock::time_point now);
+
+      /**
+       * @brief Set the number of messages written between two flushes. Should be set before the sink is used.
+       * @param batchSize Batch size. 0 is treated as 1.
+       */
+      void setBatchSize(size_t batchSize);
+
+      /**
+       * @brief Set the filter of the sink. Should be set before the sink is used.
+       * @param filter Filter applied to the messages, after the level threshold.
+       */
+      void setFilter(LogFilter filter);
+
+      /**
+       * @brief Set the maximum time a written message can wait before being flushed. Should be set before the sink is
+       *        used.
+       * @param flushInterval Flush interval.
+       */
+      void setFlushInterval(std::chrono::milliseconds flushInterval);
+
+      /**
+       * @brief Set the level threshold of the sink.
+       * @param level Minimum level of the messages written by the sink.
+       */
+      void setLevel(LogMsg::Level level);
+
+      /**
+       * @brief Take the output that failed since the last call, so that each failure is reported once.
+       * @param output Name of the output that failed, set on success.
+       * @return true if a new failure must be reported, false otherwise.
+       */
+      bool takeFailure(std::string& output);
+
+      /**
+       * @brief Write a message and flush the output if a batch is complete.
+       * @param message Message to write.
+       * @param text Rendered message, terminated by a new line. Empty if no sink needs text.
+       * @param now Current time.
+       */
+      void write(const LogMsg& message, std::string_view text, Clock::time_point now);
+
+   protected:
+      /**
+       * @brief Record that the output failed. Further failures are not reported again until recover_ is called.
+       * @param output Name of the output that failed.
+       */
+      void fail_(std::string_view output);
+
+      /**
+       * @brief Flush the actual output.
+       */
+      virtual void flush_() = 0;
+
+      /**
+       * @brief Record that the output works again after a failure.
+       */
+      void recover_();
+
+      /**
+       * @brief Write a message on the actual output.
+       * @param message Message to write.
+       * @param text Rendered message, terminated by a new line.
+       */
+      virtual void write_(const LogMsg& message, std::string_view text) = 0;
+
+   private:
+      std::atomic<LogMsg::Level> level_{ LogMsg::Level::trace };           /**< Level threshold. */
+      LogFilter                  filter_;                                  /**< Filter of the messages. */
+      size_t                     batchSize_{ default_batch_size };         /**< Messages between flushes. */
+      std::chrono::milliseconds  flushInterval_{ default_flush_interval }; /**< Time between flushes. */
+      size_t                     pending_{ 0U };                           /**< Messages written since last flush. */
+      Clock::time_point          lastFlush_{ Clock::now() };               /**< Time of the last flush. */
+      std::string                failedOutput_;                            /**< Output that failed. */
+      bool                       failed_{ false };                         /**< Whether the output is failing. */
+      bool                       unreported_{ false };                     /**< Whether the failure awaits a report. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_LOGSINK_HPP
@@ -0,0 +1,164 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "LogSite.hpp"
+
+#include <algorithm>
+
+namespace cjm::io
+{
+   using cjm::data::LogMsg;
+
+   /********** STATIC VARIABLES DEFINITIONS **********/
+   std::atomic<LogSite*> LogSite::head_{ nullptr };
+   std::atomic<bool>     LogSite::defaultEnabled_{ true };
+
+   std::vector<std::pair<std::string, std::uint32_t>> LogSite::samplingRules_;
+   std::mutex                                         LogSite::samplingMtx_;
+
+   /********** METHOD DEFINITIONS **********/
+   LogSite::LogSite(const char* file, int line, const char* function, LogMsg::Level level) :
+      file_{ file }, line_{ line }, function_{ function }, level_{ level }
+   {
+      enabled_.store(defaultEnabled_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+      // Apply the sampling rules and register the site together, so that no new rule is missed in between.
+      std::scoped_lock lck{ samplingMtx_ };
+      for (const auto& [pattern, sampling] : samplingRules_)
+      {
+         if (matches_(pattern)) sampling_.store(sampling, std::memory_order_relaxed);
+      }
+
+      // Push the site at the head of the list.
+      next_ = head_.load(std::memory_order_relaxed);
+      while (!head_.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed))
+      {
+      }
+   }
+
+   void LogSite::clearSampling()
+   {
+      std::scoped_lock lck{ samplingMtx_ };
+      samplingRules_.clear();
+      for (LogSite* site = head_.load(std::memory_order_acquire); site != nullptr; site = site->next_)
+      {
+         site->setSampling(0U);
+      }
+   }
+
+   const char* LogSite::file() const
+   {
+      return file_;
+   }
+
+   const char* LogSite::function() const
+   {
+      return function_;
+   }
+
+   LogMsg::Level LogSite::level() const
+   {
+      return level_;
+   }
+
+   int LogSite::line() const
+   {
+      return line_;
+   }
+
+   void LogSite::setAllEnabled(bool enabled)
+   {
+      defaultEnabled_ = enabled;
+      for (LogSite* site = head_.load(std::memory_order_acquire); site != nullptr; site = site->next_)
+      {
+         site->setEnabled(enabled);
+      }
+   }
+
+   void LogSite::setEnabled(bool enabled)
+   {
+      enabled_.store(enabled, std::memory_order_relaxed);
+   }
+
+   size_t LogSite::setEnabled(std::string_view pattern, bool enabled)
+   {
+      size_t count{ 0U };
+      for (LogSite* site = head_.load(std::memory_order_acquire); site != nullptr; site = site->next_)
+      {
+         if (site->matches_(pattern))
+         {
+            site->setEnabled(enabled);
+            ++count;
+         }
+      }
+
+      return count;
+   }
+
+   void LogSite::setSampling(std::uint32_t sampling)
+   {
+      sampling_.store(sampling, std::memory_order_relaxed);
+   }
+
+   size_t LogSite::setSampling(std::string_view pattern, std::uint32_t sampling)
+   {
+      std::scoped_lock lck{ samplingMtx_ };
+
+      // The replaced rule is moved last, since rules are applied to new sites in order.
+      auto rule = std::find_if(samplingRules_.begin(), samplingRules_.end(), [&pattern](const auto& current) {
+         return current.first == pattern;
+      });
+      if (rule != samplingRules_.end()) samplingRules_.erase(rule);
+      samplingRules_.emplace_back(pattern, sampling);
+
+      size_t count{ 0U };
+      for (LogSite* site = head_.load(std::memory_order_acquire); site != nullptr; site = site->next_)
+      {
+         if (site->matches_(pattern))
+         {
+            site->setSampling(sampling);
+            ++count;
+         }
+      }
+
+      return count;
+   }
+
+   std::vector<LogSite*> LogSite::sites()
+   {
+      std::vector<LogSite*> sites;
+      for (LogSite* site = head_.load(std::memory_order_acquire); site != nullptr; site = site->next_)
+      {
+         sites.emplace_back(site);
+      }
+
+      return sites;
+   }
+
+   bool LogSite::matches_(std::string_view pattern) const
+   {
+      return std::string_view(file_).find(pattern) != std::string_view::npos ||
+             std::string_view(function_).find(pattern) != std::string_view::npos;
+   }
+} // namespace cjm::io
@@ -0,0 +1,186 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_LOGSITE_HPP
+#define COMMON_IO_LOGSITE_HPP
+
+#include "common/data/LogMsg.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cjm::io
+{
+   /**
+    * @brief Source location of a logging call that can be enabled or disabled at runtime.
+    * @details Sites are created by the CJM_LOG_* macros as function-local statics and register themselves in a global
+    *          list the first time the call is executed. They are never destroyed before the end of the program.
+    *          A site can also be sampled: only one message in N is logged, N being its sampling rate.
+    */
+   class LogSite
+   {
+   public:
+      using LogMsg = cjm::data::LogMsg;
+
+      /**
+       * @brief Create and register a logging site.
+       * @param file Source file of the call.
+       * @param line Line of the call.
+       * @param function Function that contains the call.
+       * @param level Level of the logged message.
+       */
+      LogSite(const char* file, int line, const char* function, LogMsg::Level level);
+
+      /**
+       * @brief Copy constructor.
+       */
+      LogSite(const LogSite&) = delete;
+
+      /**
+       * @brief Copy-assignment operator.
+       */
+      LogSite& operator=(const LogSite&) = delete;
+
+      /**
+       * @brief Remove every sampling rule set by pattern, and let every registered site follow the rate of its level.
+       */
+      static void clearSampling();
+
+      /**
+       * @brief Check whether the site is enabled.
+       * @return true or false.
+       */
+      bool enabled() const
+      {
+         return enabled_.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Get the source file of the call.
+       * @return Source file of the call.
+       */
+      const char* file() const;
+
+      /**
+       * @brief Get the function that contains the call.
+       * @return Name of the function.
+       */
+      const char* function() const;
+
+      /**
+       * @brief Get the sampling rate of the site.
+       * @return N if one message in N is logged, 0 if the site follows the rate of its level.
+       */
+      std::uint32_t sampling() const
+      {
+         return sampling_.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Get the level of the logged message.
+       * @return Level of the logged message.
+       */
+      LogMsg::Level level() const;
+
+      /**
+       * @brief Get the line of the call.
+       * @return Line of the call.
+       */
+      int line() const;
+
+      /**
+       * @brief Enable or disable every site, including the ones that have not been registered yet.
+       * @param enabled true to enable the sites, false to disable them.
+       */
+      static void setAllEnabled(bool enabled);
+
+      /**
+       * @brief Enable or disable the site.
+       * @param enabled true to enable the site, false to disable it.
+       */
+      void setEnabled(bool enabled);
+
+      /**
+       * @brief Enable or disable every registered site whose file or function contains a given text.
+       * @param pattern Text to look for.
+       * @param enabled true to enable the sites, false to disable them.
+       * @return Number of affected sites.
+       */
+      static size_t setEnabled(std::string_view pattern, bool enabled);
+
+      /**
+       * @brief Set the sampling rate of the site.
+       * @param sampling N to log one message in N, 0 to follow the rate of the level.
+       */
+      void setSampling(std::uint32_t sampling);
+
+      /**
+       * @brief Set the sampling rate of every site whose file or function contains a given text, including the sites
+       *        registered later.
+       * @details A rule already set for the same text is replaced.
+       * @param pattern Text to look for.
+       * @param sampling N to log one message in N, 0 to follow the rate of the level.
+       * @return Number of affected registered sites.
+       */
+      static size_t setSampling(std::string_view pattern, std::uint32_t sampling);
+
+      /**
+       * @brief Get all registered sites.
+       * @return Registered sites, from the most recent to the oldest.
+       */
+      static std::vector<LogSite*> sites();
+
+   private:
+      /**
+       * @brief Check whether the file or function of the site contains a given text.
+       * @param pattern Text to look for.
+       * @return true or false.
+       */
+      bool matches_(std::string_view pattern) const;
+
+      static std::atomic<LogSite*> head_;           /**< Most recently registered site. */
+      static std::atomic<bool>     defaultEnabled_; /**< State of newly registered sites. */
+
+      /**
+       * @brief Sampling rates set by pattern, in the order they were set, also applied to the sites registered later.
+       */
+      static std::vector<std::pair<std::string, std::uint32_t>> samplingRules_;
+      static std::mutex                                         samplingMtx_; /**< Mutex protecting the rules. */
+
+      const char*                file_;            /**< Source file of the call. */
+      int                        line_;            /**< Line of the call. */
+      const char*                function_;        /**< Function that contains the call. */
+      LogMsg::Level              level_;           /**< Level of the logged message. */
+      std::atomic<bool>          enabled_{ true }; /**< true if the call is enabled. */
+      std::atomic<std::uint32_t> sampling_{ 0U };  /**< Sampling rate, 0 to follow the level. */
+      LogSite*                   next_{ nullptr }; /**< Next registered site. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_LOGSITE_HPP
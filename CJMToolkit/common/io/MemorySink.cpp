@@ -0,0 +1,72 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "MemorySink.hpp"
+
+namespace cjm::io
+{
+   MemorySink::MemorySink(size_t capacity) : capacity_{ capacity > 0U ? capacity : 1U }
+   {
+   }
+
+   size_t MemorySink::capacity() const
+   {
+      return capacity_;
+   }
+
+   void MemorySink::clear()
+   {
+      std::scoped_lock lck{ mtx_ };
+      lines_.clear();
+   }
+
+   std::vector<std::string> MemorySink::lines() const
+   {
+      std::scoped_lock lck{ mtx_ };
+      return std::vector<std::string>(lines_.begin(), lines_.end());
+   }
+
+   void MemorySink::flush_()
+   {
+   }
+
+   void MemorySink::write_(const LogMsg&, std::string_view text)
+   {
+      if (!text.empty() && text.back() == '\n') text.remove_suffix(1U);
+
+      std::scoped_lock lck{ mtx_ };
+      if (lines_.size() == capacity_)
+      {
+         // Reuse the memory of the oldest message.
+         std::string oldest{ std::move(lines_.front()) };
+         lines_.pop_front();
+         oldest.assign(text);
+         lines_.emplace_back(std::move(oldest));
+      }
+      else
+      {
+         lines_.emplace_back(text);
+      }
+   }
+} // namespace cjm::io
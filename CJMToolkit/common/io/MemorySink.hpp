@@ -0,0 +1,97 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_MEMORYSINK_HPP
+#define COMMON_IO_MEMORYSINK_HPP
+
+#include "LogSink.hpp"
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cjm::io
+{
+   /**
+    * @brief Sink that keeps the most recent rendered messages in memory, for display or inspection.
+    */
+   class MemorySink : public LogSink
+   {
+   public:
+      static constexpr std::string_view type{ "memory" };          /**< Type of the sink in the settings. */
+      static constexpr size_t           default_capacity{ 1000U }; /**< Default number of retained messages. */
+
+      /**
+       * @brief Names of the settings nodes of memory sinks.
+       */
+      struct Keys
+      {
+         static constexpr std::string_view capacity{ "Capacity" }; /**< Number of retained messages. */
+      };
+
+      /**
+       * @brief Constructor.
+       * @param capacity Number of retained messages. When it is exceeded, the oldest message is discarded.
+       */
+      MemorySink(size_t capacity = default_capacity);
+
+      /**
+       * @brief Get the maximum number of retained messages.
+       * @return Capacity of the sink.
+       */
+      size_t capacity() const;
+
+      /**
+       * @brief Discard every retained message.
+       */
+      void clear();
+
+      /**
+       * @brief Get a copy of the retained messages.
+       * @return Rendered messages without the final new line, from the oldest to the newest.
+       */
+      std::vector<std::string> lines() const;
+
+   protected:
+      /**
+       * @brief Nothing to flush, messages are available as soon as they are written.
+       */
+      void flush_() override;
+
+      /**
+       * @brief Store a message.
+       * @param message Message to store.
+       * @param text Rendered message, terminated by a new line.
+       */
+      void write_(const LogMsg& message, std::string_view text) override;
+
+   private:
+      size_t                  capacity_{ default_capacity }; /**< Number of retained messages. */
+      std::deque<std::string> lines_;                        /**< Retained messages. */
+      mutable std::mutex      mtx_;                          /**< Mutex protecting the retained messages. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_MEMORYSINK_HPP
@@ -0,0 +1,213 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "MmapFileSink.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+namespace cjm::io
+{
+   namespace
+   {
+      /**
+       * @brief Get the size of a memory page.
+       */
+      size_t pageSize()
+      {
+         static const auto size{ static_cast<size_t>(sysconf(_SC_PAGESIZE)) };
+         return size;
+      }
+
+      /**
+       * @brief Round a size up to a multiple of the page size.
+       */
+      size_t pageAlign(size_t size)
+      {
+         return std::max(pageSize(), (size + pageSize() - 1U) / pageSize() * pageSize());
+      }
+   } // namespace
+
+   MmapFileSink::MmapFileSink(std::string_view fileName, size_t segmentSize) :
+      fileName_{ fileName }, segmentSize_{ pageAlign(segmentSize) }
+   {
+   }
+
+   MmapFileSink::~MmapFileSink()
+   {
+      closeSegment_();
+   }
+
+   const std::string& MmapFileSink::fileName() const
+   {
+      return fileName_;
+   }
+
+   bool MmapFileSink::init()
+   {
+      if (mapping_ != nullptr) return true;
+      return openSegment_(0U);
+   }
+
+   size_t MmapFileSink::segment() const
+   {
+      return segment_.load(std::memory_order_relaxed);
+   }
+
+   std::string MmapFileSink::segmentName(size_t index) const
+   {
+      return fileName_ + "." + std::to_string(index);
+   }
+
+   size_t MmapFileSink::segmentSize() const
+   {
+      return segmentSize_;
+   }
+
+   void MmapFileSink::takeOver(MmapFileSink& other)
+   {
+      other.flush();
+      if (other.segmentSize_ != segmentSize_)
+      {
+         other.closeSegment_();
+         segment_.store(other.segment() + 1U, std::memory_order_relaxed);
+         return;
+      }
+
+      fd_ = std::exchange(other.fd_, -1);
+      mapping_ = std::exchange(other.mapping_, nullptr);
+      synced_ = other.synced_;
+      cursor_.store(other.cursor_.load(std::memory_order_relaxed), std::memory_order_release);
+      segment_.store(other.segment(), std::memory_order_relaxed);
+   }
+
+   size_t MmapFileSink::written() const
+   {
+      return cursor_.load(std::memory_order_acquire);
+   }
+
+   void MmapFileSink::flush_()
+   {
+      if (mapping_ == nullptr) return;
+
+      // Only whole pages can be synchronised: start from the page that holds the first unsynchronised byte.
+      size_t cursor{ cursor_.load(std::memory_order_relaxed) };
+      size_t begin{ synced_ / pageSize() * pageSize() };
+      if (cursor > begin) msync(mapping_ + begin, cursor - begin, MS_ASYNC);
+      synced_ = cursor;
+   }
+
+   void MmapFileSink::write_(const LogMsg&, std::string_view text)
+   {
+      // A segment that could not be opened is retried with every message, until it succeeds.
+      if (mapping_ == nullptr && !reopenSegment_(segment_.load(std::memory_order_relaxed))) return;
+
+      while (!text.empty())
+      {
+         size_t cursor{ cursor_.load(std::memory_order_relaxed) };
+         size_t size{ std::min(text.size(), segmentSize_ - cursor) };
+         std::memcpy(mapping_ + cursor, text.data(), size);
+         cursor_.store(cursor + size, std::memory_order_release);
+         text.remove_prefix(size);
+
+         // Records that do not fit continue in the next segment.
+         if (cursor + size == segmentSize_)
+         {
+            size_t next{ segment_.load(std::memory_order_relaxed) + 1U };
+            closeSegment_();
+            if (!reopenSegment_(next)) return;
+         }
+      }
+   }
+
+   void MmapFileSink::closeSegment_()
+   {
+      if (mapping_ != nullptr)
+      {
+         munmap(mapping_, segmentSize_);
+         mapping_ = nullptr;
+      }
+
+      if (fd_ >= 0)
+      {
+         // Drop the preallocated space that was never written. If this fails, the segment keeps trailing zeros.
+         while (ftruncate(fd_, static_cast<off_t>(cursor_.load(std::memory_order_relaxed))) != 0 && errno == EINTR)
+         {
+         }
+         close(fd_);
+         fd_ = -1;
+      }
+   }
+
+   bool MmapFileSink::openSegment_(size_t index)
+   {
+      // The index is kept on failure, so that the same segment is retried.
+      segment_.store(index, std::memory_order_relaxed);
+      synced_ = 0U;
+      cursor_.store(0U, std::memory_order_release);
+
+      std::string name{ segmentName(index) };
+      fd_ = open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd_ < 0) return false;
+
+      // Reserve the blocks up front, so that writing to the mapping cannot fail for lack of space. posix_fallocate
+      // writes zeros on filesystems without fallocate. A sparse file is never used: on a full disk, writing to its
+      // mapping would raise SIGBUS.
+      auto size{ static_cast<off_t>(segmentSize_) };
+      if (fallocate(fd_, 0, 0, size) != 0 && posix_fallocate(fd_, 0, size) != 0)
+      {
+         close(fd_);
+         fd_ = -1;
+         return false;
+      }
+
+      void* mapping{ mmap(nullptr, segmentSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0) };
+      if (mapping == MAP_FAILED)
+      {
+         close(fd_);
+         fd_ = -1;
+         return false;
+      }
+      mapping_ = static_cast<char*>(mapping);
+      madvise(mapping_, segmentSize_, MADV_SEQUENTIAL);
+      return true;
+   }
+
+   bool MmapFileSink::reopenSegment_(size_t index)
+   {
+      if (!openSegment_(index))
+      {
+         fail_(segmentName(index));
+         return false;
+      }
+
+      recover_();
+      return true;
+   }
+} // namespace cjm::io
@@ -0,0 +1,164 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_MMAPFILESINK_HPP
+#define COMMON_IO_MMAPFILESINK_HPP
+
+#include "LogSink.hpp"
+
+#include <atomic>
+#include <string>
+
+namespace cjm::io
+{
+   /**
+    * @brief Linux sink that writes text messages into memory-mapped, preallocated file segments.
+    * @details Each segment is a file of fixed size, reserved with fallocate and mapped in memory. A segment whose
+    *          blocks cannot be reserved is refused rather than mapped sparse, since writing to a sparse mapping on a
+    *          full disk raises SIGBUS. Messages are copied
+    *          into the mapping and the write cursor is published atomically, so other threads can see how much of the
+    *          segment is valid. The kernel writes the pages back in the background. When a segment is full, it is
+    *          closed and the next one is created. Segments are named after the file, followed by their index.
+    */
+   class MmapFileSink : public LogSink
+   {
+   public:
+      static constexpr std::string_view type{ "mmap" };            /**< Type of the sink in the settings. */
+      static constexpr size_t           mebibyte{ 1024U * 1024U }; /**< Bytes in a MiB. */
+
+      /**
+       * @brief Default size of a segment [B].
+       */
+      static constexpr size_t default_segment_size{ 64U * mebibyte };
+
+      /**
+       * @brief Names of the settings nodes of memory-mapped sinks.
+       */
+      struct Keys
+      {
+         static constexpr std::string_view file{ "File" };                /**< Base path of the segments. */
+         static constexpr std::string_view segment_size{ "SegmentSize" }; /**< Size of a segment [MiB]. */
+      };
+
+      /**
+       * @brief Constructor.
+       * @param fileName Base path of the segments.
+       * @param segmentSize Size of a segment [B]. Rounded up to a multiple of the page size.
+       */
+      MmapFileSink(std::string_view fileName, size_t segmentSize = default_segment_size);
+
+      /**
+       * @brief Destructor. Trims the last segment to its used size.
+       */
+      ~MmapFileSink() override;
+
+      /**
+       * @brief Get the base path of the segments.
+       * @return Base path of the segments.
+       */
+      const std::string& fileName() const;
+
+      /**
+       * @brief Create and map the first segment.
+       * @return true on success, false otherwise.
+       */
+      bool init();
+
+      /**
+       * @brief Get the index of the segment being written. Can be called from any thread.
+       * @return Index of the current segment.
+       */
+      size_t segment() const;
+
+      /**
+       * @brief Get the path of a segment.
+       * @param index Index of the segment.
+       * @return Path of the segment.
+       */
+      std::string segmentName(size_t index) const;
+
+      /**
+       * @brief Get the size of a segment.
+       * @return Size of a segment [B].
+       */
+      size_t segmentSize() const;
+
+      /**
+       * @brief Continue writing the segments of another sink, instead of truncating them.
+       * @details With the same segment size, the current segment and its mapping are moved to this sink. Otherwise,
+       *          the segment of the other sink is closed and this sink starts the next one with its first message.
+       * @param other Sink that writes the same segments. Its segment is closed.
+       */
+      void takeOver(MmapFileSink& other);
+
+      /**
+       * @brief Get the number of valid bytes in the current segment. Can be called from any thread.
+       * @return Valid bytes in the current segment.
+       */
+      size_t written() const;
+
+   protected:
+      /**
+       * @brief Ask the kernel to start writing back the dirty pages, without waiting.
+       */
+      void flush_() override;
+
+      /**
+       * @brief Copy a message into the mapping, rolling to a new segment when the current one is full.
+       * @param message Message to write.
+       * @param text Rendered message, terminated by a new line.
+       */
+      void write_(const LogMsg& message, std::string_view text) override;
+
+   private:
+      /**
+       * @brief Unmap the current segment and trim its file to the used size.
+       */
+      void closeSegment_();
+
+      /**
+       * @brief Create, preallocate and map a segment.
+       * @param index Index of the segment.
+       * @return true on success, false otherwise.
+       */
+      bool openSegment_(size_t index);
+
+      /**
+       * @brief Open a segment while writing, recording the failure or the recovery of the sink.
+       * @param index Index of the segment.
+       * @return true on success, false otherwise.
+       */
+      bool reopenSegment_(size_t index);
+
+      std::string         fileName_;           /**< Base path of the segments. */
+      size_t              segmentSize_;        /**< Size of a segment [B]. */
+      int                 fd_{ -1 };           /**< File descriptor of the current segment. */
+      char*               mapping_{ nullptr }; /**< Mapping of the current segment. */
+      size_t              synced_{ 0U };       /**< Bytes already handed to the kernel for writeback. */
+      std::atomic<size_t> cursor_{ 0U };       /**< Valid bytes in the current segment. */
+      std::atomic<size_t> segment_{ 0U };      /**< Index of the current segment. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_MMAPFILESINK_HPP
@@ -0,0 +1,225 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "ShmRing.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace cjm::io
+{
+   static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared-memory rings need lock-free atomics.");
+
+   ShmRing::~ShmRing()
+   {
+      unmap_();
+   }
+
+   bool ShmRing::attach(std::string_view name)
+   {
+      unmap_();
+
+      int fd{ shm_open(std::string(name).c_str(), O_RDONLY | O_CLOEXEC, 0) };
+      if (fd < 0) return false;
+
+      struct stat status{};
+      if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(Header))
+      {
+         close(fd);
+         return false;
+      }
+
+      size_t size{ static_cast<size_t>(status.st_size) };
+      void*  mapping{ mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) };
+      close(fd);
+      if (mapping == MAP_FAILED) return false;
+
+      header_ = static_cast<Header*>(mapping);
+      size_ = size;
+
+      // Reject objects that are not rings, or whose declared layout does not fit in the object.
+      if (std::string_view(header_->magic, sizeof(header_->magic)) != magic || header_->slots == 0U ||
+          header_->slotSize < min_slot_size || (size - sizeof(Header)) / header_->slotSize < header_->slots)
+      {
+         unmap_();
+         return false;
+      }
+
+      return true;
+   }
+
+   bool ShmRing::create(std::string_view name, size_t slots, size_t slotSize)
+   {
+      unmap_();
+      if (slots == 0U) return false;
+
+      slotSize = std::max((slotSize + 7U) / 8U * 8U, min_slot_size);
+      size_t size{ sizeof(Header) + slots * slotSize };
+
+      // Replace the object instead of reusing it: readers of a previous ring keep their mapping of the old contents,
+      // and never see them change under their feet.
+      std::string objectName{ name };
+      shm_unlink(objectName.c_str());
+      int fd{ shm_open(objectName.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644) };
+      if (fd < 0) return false;
+
+      if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+      {
+         close(fd);
+         return false;
+      }
+
+      void* mapping{ mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+      close(fd);
+      if (mapping == MAP_FAILED) return false;
+
+      header_ = static_cast<Header*>(mapping);
+      size_ = size;
+
+      header_->slots = slots;
+      header_->slotSize = slotSize;
+      header_->writer = getpid();
+      new (&header_->head) std::atomic<std::uint64_t>{ 0U };
+      for (std::uint64_t i = 0U; i < slots; ++i)
+      {
+         new (&slot_(i)->stamp) std::atomic<std::uint64_t>{ 0U };
+      }
+
+      // Publish the signature last: readers attaching earlier reject the object.
+      std::atomic_thread_fence(std::memory_order_release);
+      std::memcpy(header_->magic, magic.data(), sizeof(header_->magic));
+      return true;
+   }
+
+   std::uint64_t ShmRing::head() const
+   {
+      return header_ != nullptr ? header_->head.load(std::memory_order_acquire) : 0U;
+   }
+
+   size_t ShmRing::recordCapacity() const
+   {
+      return header_ != nullptr ? header_->slotSize - sizeof(Slot) : 0U;
+   }
+
+   ShmRing::Status ShmRing::read(std::uint64_t sequence, std::string& text, std::uint32_t& flags) const
+   {
+      if (sequence >= head()) return Status::not_written;
+
+      const Slot*   slot{ slot_(sequence) };
+      std::uint64_t complete{ 2U * sequence + 2U };
+      std::uint64_t before{ slot->stamp.load(std::memory_order_acquire) };
+      if (before > complete) return Status::overwritten;
+      if (before != complete) return Status::busy;
+
+      size_t size{ std::min<size_t>(slot->size, recordCapacity()) };
+      text.assign(reinterpret_cast<const char*>(slot + 1), size);
+      flags = slot->flags;
+
+      // A stamp changed during the copy means the writer reused the slot: the copy may be torn.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot->stamp.load(std::memory_order_relaxed) != complete) return Status::overwritten;
+      return Status::ok;
+   }
+
+   size_t ShmRing::slots() const
+   {
+      return header_ != nullptr ? header_->slots : 0U;
+   }
+
+   void ShmRing::takeOver(ShmRing& other)
+   {
+      unmap_();
+      header_ = std::exchange(other.header_, nullptr);
+      size_ = std::exchange(other.size_, 0U);
+   }
+
+   long ShmRing::writer() const
+   {
+      return header_ != nullptr ? static_cast<long>(header_->writer) : 0;
+   }
+
+   void ShmRing::write(std::string_view text)
+   {
+      if (header_ == nullptr) return;
+
+      // A text must not overwrite its own first records before a reader could join them.
+      size_t capacity{ recordCapacity() };
+      size_t longest{ capacity * std::max<size_t>(header_->slots / 4U, 1U) };
+      bool   cut{ text.size() > longest };
+      if (cut) text = text.substr(0U, longest);
+
+      std::uint32_t flags{ 0U };
+      do
+      {
+         size_t size{ std::min(text.size(), capacity) };
+         if (size < text.size())
+         {
+            flags |= continues;
+         }
+         else if (cut)
+         {
+            flags |= truncated;
+         }
+         writeRecord_(text.substr(0U, size), flags);
+         text.remove_prefix(size);
+         flags = continuation;
+      } while (!text.empty());
+   }
+
+   ShmRing::Slot* ShmRing::slot_(std::uint64_t sequence) const
+   {
+      char* slots{ reinterpret_cast<char*>(header_ + 1) };
+      return reinterpret_cast<Slot*>(slots + (sequence % header_->slots) * header_->slotSize);
+   }
+
+   void ShmRing::unmap_()
+   {
+      if (header_ == nullptr) return;
+
+      munmap(header_, size_);
+      header_ = nullptr;
+      size_ = 0U;
+   }
+
+   void ShmRing::writeRecord_(std::string_view text, std::uint32_t flags)
+   {
+      std::uint64_t sequence{ header_->head.load(std::memory_order_relaxed) };
+      Slot*         slot{ slot_(sequence) };
+
+      slot->stamp.store(2U * sequence + 1U, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      slot->size = static_cast<std::uint32_t>(text.size());
+      slot->flags = flags;
+      std::memcpy(reinterpret_cast<char*>(slot + 1), text.data(), text.size());
+      slot->stamp.store(2U * sequence + 2U, std::memory_order_release);
+
+      header_->head.store(sequence + 1U, std::memory_order_release);
+   }
+} // namespace cjm::io
@@ -0,0 +1,200 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_SHMRING_HPP
+#define COMMON_IO_SHMRING_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace cjm::io
+{
+   /**
+    * @brief Linux ring of text records in a named POSIX shared-memory object, written by one process and read by any
+    *        number of others.
+    * @details The object starts with a header followed by slots of fixed size, each holding one record. Records are
+    *          numbered from 0 and record n is stored in slot n % slots. Every slot carries a stamp: 2n + 1 while record
+    *          n is being written, 2n + 2 once it is complete. Readers copy a slot and check the stamp before and after
+    *          the copy, so they never lock the writer and detect torn or overwritten records instead.
+    *          A text longer than a slot is split over consecutive records, flagged so that readers can join them
+    *          again. Texts longer than a quarter of the ring are cut, and their last record is flagged as truncated.
+    *          The object is not removed when the writer exits, so its contents can be read after the process died.
+    */
+   class ShmRing
+   {
+   public:
+      static constexpr std::string_view magic{ "CJMSHMR2" };     /**< Signature at the beginning of the object. */
+      static constexpr size_t           default_slots{ 65536U };   /**< Default number of slots. */
+      static constexpr size_t           default_slot_size{ 256U }; /**< Default size of a slot [B]. */
+      static constexpr size_t           min_slot_size{ 64U };      /**< Smallest size of a slot [B]. */
+
+      static constexpr std::uint32_t continues{ 1U };    /**< Flag of a record continued by the next one. */
+      static constexpr std::uint32_t continuation{ 2U }; /**< Flag of a record continuing the previous one. */
+      static constexpr std::uint32_t truncated{ 4U };    /**< Flag of the last record of a text that was cut. */
+
+      /**
+       * @brief Outcome of reading a record.
+       */
+      enum class Status
+      {
+         ok,          /**< The record was copied. */
+         not_written, /**< The record has not been written yet. */
+         busy,        /**< The record is being written, try again. */
+         overwritten  /**< The record was overwritten by a newer one. */
+      };
+
+      /**
+       * @brief Default constructor.
+       */
+      ShmRing() = default;
+
+      /**
+       * @brief Copy constructor.
+       */
+      ShmRing(const ShmRing&) = delete;
+
+      /**
+       * @brief Destructor. Unmaps the object, which keeps existing.
+       */
+      ~ShmRing();
+
+      /**
+       * @brief Copy-assignment operator.
+       */
+      ShmRing& operator=(const ShmRing&) = delete;
+
+      /**
+       * @brief Map an existing ring for reading.
+       * @param name Name of the shared-memory object, starting with '/'.
+       * @return true on success, false if the object does not exist or is not a ring.
+       */
+      bool attach(std::string_view name);
+
+      /**
+       * @brief Create a ring for writing, replacing an existing object with the same name.
+       * @details Readers of the replaced object keep reading its old contents.
+       * @param name Name of the shared-memory object, starting with '/'.
+       * @param slots Number of slots.
+       * @param slotSize Size of a slot [B], including the stamp and the size of the record. Rounded up to a multiple
+       *                 of 8 and to at least min_slot_size.
+       * @return true on success, false otherwise.
+       */
+      bool create(std::string_view name, size_t slots = default_slots, size_t slotSize = default_slot_size);
+
+      /**
+       * @brief Get the number of the next record to be written.
+       * @return Number of records written so far.
+       */
+      std::uint64_t head() const;
+
+      /**
+       * @brief Get the largest record stored by a slot. Longer texts are split over several records.
+       * @return Capacity of a slot [B].
+       */
+      size_t recordCapacity() const;
+
+      /**
+       * @brief Copy a record.
+       * @param sequence Number of the record.
+       * @param text Copy of the record, only valid if the record was read.
+       * @param flags Combination of continues, continuation and truncated, only valid if the record was read.
+       * @return Outcome of the read.
+       */
+      Status read(std::uint64_t sequence, std::string& text, std::uint32_t& flags) const;
+
+      /**
+       * @brief Get the number of slots.
+       * @return Number of slots, 0 if no ring is mapped.
+       */
+      size_t slots() const;
+
+      /**
+       * @brief Continue writing the ring mapped by another writer, instead of replacing the object.
+       * @param other Writer of the ring. Its mapping is moved to this ring.
+       */
+      void takeOver(ShmRing& other);
+
+      /**
+       * @brief Get the process id of the writer.
+       * @return Process id of the writer.
+       */
+      long writer() const;
+
+      /**
+       * @brief Append a text, as one record or as several records if it is longer than a slot. Only one thread at a
+       *        time may write.
+       * @param text Text to append, cut to a quarter of the ring.
+       */
+      void write(std::string_view text);
+
+   private:
+      /**
+       * @brief Layout of the beginning of the object.
+       */
+      struct Header
+      {
+         char                       magic[8]; /**< Signature of the object. */
+         std::uint64_t              slots;    /**< Number of slots. */
+         std::uint64_t              slotSize; /**< Size of a slot [B]. */
+         std::int64_t               writer;   /**< Process id of the writer. */
+         std::atomic<std::uint64_t> head;     /**< Number of the next record. */
+      };
+
+      /**
+       * @brief Layout of the beginning of a slot, followed by the text of the record.
+       */
+      struct Slot
+      {
+         std::atomic<std::uint64_t> stamp; /**< 2n + 1 while record n is written, 2n + 2 once it is complete. */
+         std::uint32_t              size;  /**< Size of the record [B]. */
+         std::uint32_t              flags; /**< Combination of continues, continuation and truncated. */
+      };
+
+      /**
+       * @brief Get a slot.
+       * @param sequence Number of a record stored in the slot.
+       * @return Slot of the record.
+       */
+      Slot* slot_(std::uint64_t sequence) const;
+
+      /**
+       * @brief Unmap the object.
+       */
+      void unmap_();
+
+      /**
+       * @brief Append one record.
+       * @param text Text of the record, no longer than the capacity of a slot.
+       * @param flags Flags of the record.
+       */
+      void writeRecord_(std::string_view text, std::uint32_t flags);
+
+      Header* header_{ nullptr }; /**< Mapping of the object. */
+      size_t  size_{ 0U };        /**< Size of the mapping [B]. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_SHMRING_HPP
@@ -0,0 +1,69 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "ShmSink.hpp"
+
+namespace cjm::io
+{
+   ShmSink::ShmSink(std::string_view name, size_t slots, size_t slotSize) :
+      name_{ name }, slots_{ slots }, slotSize_{ slotSize }
+   {
+   }
+
+   bool ShmSink::init()
+   {
+      if (ring_.slots() > 0U) return true;
+      return ring_.create(name_, slots_, slotSize_);
+   }
+
+   const std::string& ShmSink::name() const
+   {
+      return name_;
+   }
+
+   size_t ShmSink::slots() const
+   {
+      return slots_;
+   }
+
+   size_t ShmSink::slotSize() const
+   {
+      return slotSize_;
+   }
+
+   void ShmSink::takeOver(ShmSink& other)
+   {
+      ring_.takeOver(other.ring_);
+   }
+
+   void ShmSink::flush_()
+   {
+   }
+
+   void ShmSink::write_(const LogMsg&, std::string_view text)
+   {
+      if (!text.empty() && text.back() == '\n') text.remove_suffix(1U);
+      ring_.write(text);
+   }
+} // namespace cjm::io
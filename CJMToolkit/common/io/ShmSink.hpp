@@ -0,0 +1,117 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_SHMSINK_HPP
+#define COMMON_IO_SHMSINK_HPP
+
+#include "LogSink.hpp"
+#include "ShmRing.hpp"
+
+#include <string>
+
+namespace cjm::io
+{
+   /**
+    * @brief Linux sink that publishes rendered messages in a shared-memory ring, one message per record.
+    * @details Other processes can follow the log live with cjm-logtail, or read it after the process died, without
+    *          the application writing to disk or to a terminal. Messages longer than a slot are split over several
+    *          records, which cjm-logtail joins again.
+    */
+   class ShmSink : public LogSink
+   {
+   public:
+      static constexpr std::string_view type{ "shm" }; /**< Type of the sink in the settings. */
+
+      /**
+       * @brief Names of the settings nodes of shared-memory sinks.
+       */
+      struct Keys
+      {
+         static constexpr std::string_view name{ "Name" };          /**< Name of the shared-memory object. */
+         static constexpr std::string_view slots{ "Slots" };        /**< Number of records in the ring. */
+         static constexpr std::string_view slot_size{ "SlotSize" }; /**< Size of a record slot [B]. */
+      };
+
+      /**
+       * @brief Constructor.
+       * @param name Name of the shared-memory object, starting with '/'.
+       * @param slots Number of records in the ring.
+       * @param slotSize Size of a record slot [B].
+       */
+      ShmSink(
+         std::string_view name, size_t slots = ShmRing::default_slots, size_t slotSize = ShmRing::default_slot_size);
+
+      /**
+       * @brief Create the ring.
+       * @return true on success, false otherwise.
+       */
+      bool init();
+
+      /**
+       * @brief Get the name of the shared-memory object.
+       * @return Name of the shared-memory object.
+       */
+      const std::string& name() const;
+
+      /**
+       * @brief Get the number of records in the ring.
+       * @return Number of records in the ring.
+       */
+      size_t slots() const;
+
+      /**
+       * @brief Get the size of a record slot.
+       * @return Size of a record slot [B], as configured.
+       */
+      size_t slotSize() const;
+
+      /**
+       * @brief Continue publishing in the ring created by another sink, instead of replacing it.
+       * @param other Sink that publishes in the same object, with the same number and size of slots. Its ring is
+       *              moved to this sink.
+       */
+      void takeOver(ShmSink& other);
+
+   protected:
+      /**
+       * @brief Nothing to flush, records are visible as soon as they are written.
+       */
+      void flush_() override;
+
+      /**
+       * @brief Publish a message in the ring, without its final new line.
+       * @param message Message to write.
+       * @param text Rendered message, terminated by a new line.
+       */
+      void write_(const LogMsg& message, std::string_view text) override;
+
+   private:
+      std::string name_;     /**< Name of the shared-memory object. */
+      size_t      slots_;    /**< Number of records in the ring. */
+      size_t      slotSize_; /**< Size of a record slot [B]. */
+      ShmRing     ring_;     /**< Ring of the published messages. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_SHMSINK_HPP
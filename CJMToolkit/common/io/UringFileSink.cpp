@@ -0,0 +1,417 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "UringFileSink.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+namespace cjm::io
+{
+   namespace
+   {
+      /**
+       * @brief Set up an io_uring instance.
+       */
+      int uringSetup(unsigned entries, io_uring_params& params)
+      {
+         return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+      }
+
+      /**
+       * @brief Submit entries and optionally wait for completions.
+       */
+      int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+      {
+         return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+      }
+
+      /**
+       * @brief Map a region of an io_uring instance.
+       */
+      void* uringMap(int fd, size_t size, off_t offset)
+      {
+         void* address{ mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset) };
+         return address == MAP_FAILED ? nullptr : address;
+      }
+
+      /**
+       * @brief Get a pointer to a field of a mapped ring.
+       */
+      template<typename Type>
+      Type* ringField(void* ring, unsigned offset)
+      {
+         return reinterpret_cast<Type*>(static_cast<char*>(ring) + offset);
+      }
+   } // namespace
+
+   UringFileSink::UringFileSink(std::string_view fileName) : fileName_{ fileName }
+   {
+   }
+
+   UringFileSink::~UringFileSink()
+   {
+      if (fd_ >= 0)
+      {
+         flush_();
+         while (inFlight_ > 0U)
+         {
+            reap_(true);
+         }
+         close(fd_);
+      }
+
+      closeRing_();
+      for (auto& buffer : buffers_)
+      {
+         std::free(buffer.data);
+      }
+   }
+
+   UringFileSink::Latency UringFileSink::completionLatency() const
+   {
+      Latency latency;
+      latency.count = completions_.load(std::memory_order_relaxed);
+      latency.totalNs = totalNs_.load(std::memory_order_relaxed);
+      latency.maxNs = maxNs_.load(std::memory_order_relaxed);
+      latency.errors = errors_.load(std::memory_order_relaxed);
+      return latency;
+   }
+
+   const std::string& UringFileSink::fileName() const
+   {
+      return fileName_;
+   }
+
+   bool UringFileSink::init()
+   {
+      if (fd_ >= 0) return true;
+
+      for (auto& buffer : buffers_)
+      {
+         if (buffer.data == nullptr)
+         {
+            buffer.data = static_cast<char*>(std::aligned_alloc(buffer_alignment, buffer_size));
+            if (buffer.data == nullptr) return false;
+         }
+      }
+
+      fd_ = open(fileName_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd_ < 0) return false;
+
+      // Without io_uring, submitted buffers wait for a pwritev on the next flush.
+      if (!initRing_()) closeRing_();
+
+      return true;
+   }
+
+   void UringFileSink::takeOver(UringFileSink& other)
+   {
+      // No write of the other sink may be in flight when its buffers and its ring change hands.
+      other.flush();
+      while (other.inFlight_ > 0U)
+      {
+         other.reap_(true);
+      }
+
+      closeRing_();
+      std::swap(ring_, other.ring_);
+      for (size_t i = 0U; i < buffers_.size(); ++i)
+      {
+         std::swap(buffers_[i].data, other.buffers_[i].data);
+      }
+      current_ = nullptr;
+      fd_ = std::exchange(other.fd_, -1);
+      offset_ = other.offset_;
+   }
+
+   bool UringFileSink::usingUring() const
+   {
+      return ring_.fd >= 0;
+   }
+
+   void UringFileSink::flush_()
+   {
+      if (fd_ < 0) return;
+
+      if (current_ != nullptr && current_->size > 0U)
+      {
+         submit_(*current_);
+         current_ = nullptr;
+      }
+
+      if (usingUring())
+      {
+         reap_(false);
+      }
+      else
+      {
+         writePending_();
+      }
+   }
+
+   void UringFileSink::write_(const LogMsg&, std::string_view text)
+   {
+      if (fd_ < 0) return;
+
+      while (!text.empty())
+      {
+         if (current_ == nullptr) current_ = &acquireBuffer_();
+
+         size_t size{ std::min(text.size(), buffer_size - current_->size) };
+         std::memcpy(current_->data + current_->size, text.data(), size);
+         current_->size += size;
+         text.remove_prefix(size);
+
+         if (current_->size == buffer_size)
+         {
+            submit_(*current_);
+            current_ = nullptr;
+         }
+      }
+   }
+
+   UringFileSink::Buffer& UringFileSink::acquireBuffer_()
+   {
+      while (true)
+      {
+         for (auto& buffer : buffers_)
+         {
+            if (!buffer.busy) return buffer;
+         }
+
+         // Every buffer is in flight: this is the only place where the sink waits.
+         if (usingUring())
+         {
+            reap_(true);
+         }
+         else
+         {
+            writePending_();
+         }
+      }
+   }
+
+   void UringFileSink::closeRing_()
+   {
+      if (ring_.sqes != nullptr) munmap(ring_.sqes, ring_.sqesSize);
+      if (ring_.cqRing != nullptr && ring_.cqRing != ring_.sqRing) munmap(ring_.cqRing, ring_.cqRingSize);
+      if (ring_.sqRing != nullptr) munmap(ring_.sqRing, ring_.sqRingSize);
+      if (ring_.fd >= 0) close(ring_.fd);
+      ring_ = Ring{};
+   }
+
+   void UringFileSink::complete_(Buffer& buffer, long result, Clock::time_point now)
+   {
+      if (result < 0)
+      {
+         errors_.fetch_add(1U, std::memory_order_relaxed);
+      }
+      else if (static_cast<size_t>(result) < buffer.size)
+      {
+         // Finish a short write synchronously, it is rare enough not to be worth a resubmission.
+         size_t written{ static_cast<size_t>(result) };
+         while (written < buffer.size)
+         {
+            ssize_t size{ pwrite(fd_, buffer.data + written, buffer.size - written, buffer.offset + written) };
+            if (size <= 0)
+            {
+               if (size < 0 && errno == EINTR) continue;
+               errors_.fetch_add(1U, std::memory_order_relaxed);
+               break;
+            }
+            written += static_cast<size_t>(size);
+         }
+      }
+
+      auto latency{ static_cast<std::uint64_t>(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(now - buffer.submitted).count()) };
+      completions_.fetch_add(1U, std::memory_order_relaxed);
+      totalNs_.fetch_add(latency, std::memory_order_relaxed);
+      if (latency > maxNs_.load(std::memory_order_relaxed)) maxNs_.store(latency, std::memory_order_relaxed);
+
+      buffer.size = 0U;
+      buffer.busy = false;
+      --inFlight_;
+   }
+
+   bool UringFileSink::initRing_()
+   {
+      io_uring_params params{};
+      ring_.fd = uringSetup(buffer_count, params);
+      if (ring_.fd < 0) return false;
+
+      ring_.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+      ring_.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+      if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0U)
+      {
+         ring_.sqRingSize = std::max(ring_.sqRingSize, ring_.cqRingSize);
+         ring_.cqRingSize = ring_.sqRingSize;
+      }
+
+      ring_.sqRing = uringMap(ring_.fd, ring_.sqRingSize, IORING_OFF_SQ_RING);
+      if (ring_.sqRing == nullptr) return false;
+
+      if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0U)
+      {
+         ring_.cqRing = ring_.sqRing;
+      }
+      else
+      {
+         ring_.cqRing = uringMap(ring_.fd, ring_.cqRingSize, IORING_OFF_CQ_RING);
+         if (ring_.cqRing == nullptr) return false;
+      }
+
+      ring_.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+      ring_.sqes = static_cast<io_uring_sqe*>(uringMap(ring_.fd, ring_.sqesSize, IORING_OFF_SQES));
+      if (ring_.sqes == nullptr) return false;
+
+      ring_.sqHead = ringField<unsigned>(ring_.sqRing, params.sq_off.head);
+      ring_.sqTail = ringField<unsigned>(ring_.sqRing, params.sq_off.tail);
+      ring_.sqMask = ringField<unsigned>(ring_.sqRing, params.sq_off.ring_mask);
+      ring_.sqArray = ringField<unsigned>(ring_.sqRing, params.sq_off.array);
+      ring_.cqHead = ringField<unsigned>(ring_.cqRing, params.cq_off.head);
+      ring_.cqTail = ringField<unsigned>(ring_.cqRing, params.cq_off.tail);
+      ring_.cqMask = ringField<unsigned>(ring_.cqRing, params.cq_off.ring_mask);
+      ring_.cqes = ringField<io_uring_cqe>(ring_.cqRing, params.cq_off.cqes);
+
+      return true;
+   }
+
+   void UringFileSink::reap_(bool wait)
+   {
+      if (!usingUring() || inFlight_ == 0U) return;
+
+      if (wait)
+      {
+         int result{ uringEnter(ring_.fd, 0U, 1U, IORING_ENTER_GETEVENTS) };
+         int error{ result < 0 ? errno : 0 };
+         if (result < 0 && error != EINTR && error != EAGAIN)
+         {
+            // The ring is unusable: nothing in flight will ever complete.
+            for (auto& buffer : buffers_)
+            {
+               if (buffer.busy) complete_(buffer, -error, Clock::now());
+            }
+            return;
+         }
+      }
+
+      Clock::time_point now{ Clock::now() };
+      unsigned          head{ *ring_.cqHead };
+      while (head != __atomic_load_n(ring_.cqTail, __ATOMIC_ACQUIRE))
+      {
+         const io_uring_cqe& cqe{ ring_.cqes[head & *ring_.cqMask] };
+         complete_(buffers_[cqe.user_data], cqe.res, now);
+         ++head;
+      }
+      __atomic_store_n(ring_.cqHead, head, __ATOMIC_RELEASE);
+   }
+
+   void UringFileSink::submit_(Buffer& buffer)
+   {
+      buffer.offset = offset_;
+      buffer.iov = iovec{ buffer.data, buffer.size };
+      buffer.submitted = Clock::now();
+      buffer.busy = true;
+      offset_ += buffer.size;
+      ++inFlight_;
+
+      if (!usingUring())
+      {
+         pending_.emplace_back(&buffer);
+         return;
+      }
+
+      // The ring has one entry per buffer, so there is always room for a new submission.
+      unsigned      tail{ *ring_.sqTail };
+      unsigned      index{ tail & *ring_.sqMask };
+      io_uring_sqe& sqe{ ring_.sqes[index] };
+      std::memset(&sqe, 0, sizeof(sqe));
+      sqe.opcode = IORING_OP_WRITEV;
+      sqe.fd = fd_;
+      sqe.addr = reinterpret_cast<std::uint64_t>(&buffer.iov);
+      sqe.len = 1U;
+      sqe.off = buffer.offset;
+      sqe.user_data = static_cast<std::uint64_t>(&buffer - buffers_.data());
+      ring_.sqArray[index] = index;
+      __atomic_store_n(ring_.sqTail, tail + 1U, __ATOMIC_RELEASE);
+
+      while (uringEnter(ring_.fd, 1U, 0U, 0U) < 0)
+      {
+         if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+         {
+            reap_(false);
+            continue;
+         }
+
+         // The kernel refused the entry: take it back, so that a later call cannot submit it again for a buffer that
+         // was reused, and write synchronously. An entry the kernel already consumed completes through the ring.
+         if (__atomic_load_n(ring_.sqHead, __ATOMIC_ACQUIRE) == tail)
+         {
+            __atomic_store_n(ring_.sqTail, tail, __ATOMIC_RELEASE);
+            complete_(buffer, 0, Clock::now());
+         }
+         return;
+      }
+   }
+
+   void UringFileSink::writePending_()
+   {
+      if (pending_.empty()) return;
+
+      std::array<iovec, buffer_count> iovs;
+      size_t                          count{ 0U };
+      for (Buffer* buffer : pending_)
+      {
+         iovs[count++] = buffer->iov;
+      }
+
+      // Pending buffers are contiguous in the file, so a single call writes all of them.
+      auto    offset{ static_cast<off_t>(pending_.front()->offset) };
+      ssize_t written{ pwritev(fd_, iovs.data(), static_cast<int>(count), offset) };
+      while (written < 0 && errno == EINTR)
+      {
+         written = pwritev(fd_, iovs.data(), static_cast<int>(count), offset);
+      }
+      int error{ written < 0 ? errno : 0 };
+
+      Clock::time_point now{ Clock::now() };
+      size_t            remaining{ written < 0 ? 0U : static_cast<size_t>(written) };
+      for (Buffer* buffer : pending_)
+      {
+         size_t bufferWritten{ std::min(remaining, buffer->size) };
+         remaining -= bufferWritten;
+         complete_(*buffer, written < 0 ? -error : static_cast<long>(bufferWritten), now);
+      }
+      pending_.clear();
+   }
+} // namespace cjm::io
@@ -0,0 +1,225 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_IO_URINGFILESINK_HPP
+#define COMMON_IO_URINGFILESINK_HPP
+
+#include "LogSink.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <linux/io_uring.h>
+#include <string>
+#include <sys/uio.h>
+
+namespace cjm::io
+{
+   /**
+    * @brief Linux sink that writes text messages to a file through io_uring.
+    * @details Messages are copied into a fixed set of page-aligned buffers. A full buffer, or the current one on flush,
+    *          is submitted as a single write and the sink moves on to a free buffer without waiting for the kernel, so
+    *          at most buffer_count writes are in flight. The sink only waits when every buffer is in flight.
+    *          If io_uring is not available, submitted buffers are written together with a single pwritev on flush.
+    *          In asynchronous mode all of this happens on the writer thread, never on the threads that log.
+    */
+   class UringFileSink : public LogSink
+   {
+   public:
+      static constexpr std::string_view type{ "uring" }; /**< Type of the sink in the settings. */
+
+      static constexpr size_t buffer_size{ 64U * 1024U }; /**< Size of a single write buffer [B]. */
+      static constexpr size_t buffer_count{ 8U };         /**< Number of buffers, and of writes in flight. */
+      static constexpr size_t buffer_alignment{ 4096U };  /**< Alignment of the buffers [B]. */
+
+      /**
+       * @brief Names of the settings nodes of io_uring sinks.
+       */
+      struct Keys
+      {
+         static constexpr std::string_view file{ "File" }; /**< Path of the file. */
+      };
+
+      /**
+       * @brief Statistics of the time between the submission of a write and its completion.
+       */
+      struct Latency
+      {
+         std::uint64_t count{ 0U };   /**< Number of completed writes. */
+         std::uint64_t totalNs{ 0U }; /**< Sum of all latencies [ns]. */
+         std::uint64_t maxNs{ 0U };   /**< Highest latency [ns]. */
+         std::uint64_t errors{ 0U };  /**< Number of failed writes. */
+      };
+
+      /**
+       * @brief Constructor.
+       * @param fileName Path of the file. It is truncated when the sink is initialised.
+       */
+      UringFileSink(std::string_view fileName);
+
+      /**
+       * @brief Destructor. Waits for every write in flight.
+       */
+      ~UringFileSink() override;
+
+      /**
+       * @brief Get the completion latency of the writes so far. Can be called from any thread.
+       * @return Latency statistics.
+       */
+      Latency completionLatency() const;
+
+      /**
+       * @brief Get the path of the file.
+       * @return Path of the file.
+       */
+      const std::string& fileName() const;
+
+      /**
+       * @brief Open the file and set up the submission ring, falling back to pwritev if io_uring is not available.
+       * @return true on success, false if the file cannot be opened.
+       */
+      bool init();
+
+      /**
+       * @brief Continue writing the file already opened by another sink, instead of truncating it.
+       * @details Waits for the writes of the other sink, then takes its file, its buffers and its ring.
+       * @param other Sink that writes the same file. Its file is closed.
+       */
+      void takeOver(UringFileSink& other);
+
+      /**
+       * @brief Check whether writes go through io_uring.
+       * @return true for io_uring, false for the pwritev fallback.
+       */
+      bool usingUring() const;
+
+   protected:
+      /**
+       * @brief Submit the current buffer and collect completed writes, without waiting.
+       */
+      void flush_() override;
+
+      /**
+       * @brief Copy a message into the current buffer, submitting it when it is full.
+       * @param message Message to write.
+       * @param text Rendered message, terminated by a new line.
+       */
+      void write_(const LogMsg& message, std::string_view text) override;
+
+   private:
+      /**
+       * @brief Write buffer.
+       */
+      struct Buffer
+      {
+         char*             data{ nullptr }; /**< Page-aligned memory. */
+         size_t            size{ 0U };      /**< Bytes used. */
+         std::uint64_t     offset{ 0U };    /**< Position of the data in the file. */
+         iovec             iov{};           /**< Vector submitted to the kernel. */
+         Clock::time_point submitted;       /**< Time of the submission. */
+         bool              busy{ false };   /**< true from submission to completion. */
+      };
+
+      /**
+       * @brief Mapped rings of io_uring.
+       */
+      struct Ring
+      {
+         int           fd{ -1 };           /**< Ring file descriptor. */
+         void*         sqRing{ nullptr };  /**< Mapped submission ring. */
+         size_t        sqRingSize{ 0U };   /**< Size of the submission ring mapping. */
+         void*         cqRing{ nullptr };  /**< Mapped completion ring, can be the same as sqRing. */
+         size_t        cqRingSize{ 0U };   /**< Size of the completion ring mapping. */
+         io_uring_sqe* sqes{ nullptr };    /**< Mapped submission entries. */
+         size_t        sqesSize{ 0U };     /**< Size of the submission entries mapping. */
+         unsigned*     sqHead{ nullptr };  /**< Head of the submission ring, advanced by the kernel. */
+         unsigned*     sqTail{ nullptr };  /**< Tail of the submission ring. */
+         unsigned*     sqMask{ nullptr };  /**< Index mask of the submission ring. */
+         unsigned*     sqArray{ nullptr }; /**< Indices of the submitted entries. */
+         unsigned*     cqHead{ nullptr };  /**< Head of the completion ring. */
+         unsigned*     cqTail{ nullptr };  /**< Tail of the completion ring. */
+         unsigned*     cqMask{ nullptr };  /**< Index mask of the completion ring. */
+         io_uring_cqe* cqes{ nullptr };    /**< Completion entries. */
+      };
+
+      /**
+       * @brief Get a free buffer, waiting for a completion or writing pending buffers if all of them are busy.
+       * @return Free buffer.
+       */
+      Buffer& acquireBuffer_();
+
+      /**
+       * @brief Unmap and close the rings.
+       */
+      void closeRing_();
+
+      /**
+       * @brief Record the completion of a write, finishing it synchronously if it was short.
+       * @param buffer Written buffer.
+       * @param result Result of the write: bytes written or negative error code.
+       * @param now Time of the completion.
+       */
+      void complete_(Buffer& buffer, long result, Clock::time_point now);
+
+      /**
+       * @brief Set up the io_uring rings.
+       * @return true on success, false if io_uring is not available.
+       */
+      bool initRing_();
+
+      /**
+       * @brief Collect completed writes.
+       * @param wait true to wait for at least one completion.
+       */
+      void reap_(bool wait);
+
+      /**
+       * @brief Submit a buffer for writing at the current end of the file.
+       * @param buffer Buffer to submit.
+       */
+      void submit_(Buffer& buffer);
+
+      /**
+       * @brief Write every pending buffer with a single pwritev. Only used without io_uring.
+       */
+      void writePending_();
+
+      std::string                      fileName_;           /**< Path of the file. */
+      int                              fd_{ -1 };           /**< File descriptor. */
+      std::uint64_t                    offset_{ 0U };       /**< End of the submitted data. */
+      Ring                             ring_;               /**< io_uring rings, unused by the fallback. */
+      std::array<Buffer, buffer_count> buffers_;            /**< Write buffers. */
+      Buffer*                          current_{ nullptr }; /**< Buffer being filled. */
+      size_t                           inFlight_{ 0U };     /**< Number of busy buffers. */
+      std::deque<Buffer*>              pending_;            /**< Buffers waiting for pwritev, in file order. */
+
+      std::atomic<std::uint64_t> completions_{ 0U }; /**< Number of completed writes. */
+      std::atomic<std::uint64_t> totalNs_{ 0U };     /**< Sum of all latencies [ns]. */
+      std::atomic<std::uint64_t> maxNs_{ 0U };       /**< Highest latency [ns]. */
+      std::atomic<std::uint64_t> errors_{ 0U };      /**< Number of failed writes. */
+   };
+} // namespace cjm::io
+
+#endif // COMMON_IO_URINGFILESINK_HPP
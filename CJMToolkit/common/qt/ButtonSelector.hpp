@@ -91,12 +91,14 @@ namespace cjm::qt
       template<typename DataList>
       bool init(const DataList& buttonData)
       {
+         using namespace cjm::data::log_literals;
+
          logger_ = cjm::io::Log::logger();
          if (logger_ == nullptr) return false;
 
          if (!initUI_(buttonData))
          {
-            logger_->error("Failed to initialise the UI.");
+            logger_->error("Failed to initialise the UI."_lt);
             return false;
          }
 
@@ -113,6 +115,7 @@ namespace cjm::qt
       template<typename DataList>
       bool initUI_(const DataList& buttonData)
       {
+         using namespace cjm::data::log_literals;
          using cjm::alg::constructObj;
          using Panel = MainPanel;
 
@@ -121,14 +124,14 @@ namespace cjm::qt
          case LayoutType::horizontal:
             if (!constructObj<QLayout, QHBoxLayout>(logger_, mainPanel_.mainLayout))
             {
-               logger_->error("Failed to create the layout.");
+               logger_->error("Failed to create the layout."_lt);
                return false;
             }
             break;
          case LayoutType::vertical:
             if (!constructObj<QLayout, QVBoxLayout>(logger_, mainPanel_.mainLayout))
             {
-               logger_->error("Failed to create the layout.");
+               logger_->error("Failed to create the layout."_lt);
                return false;
             }
             break;
@@ -142,7 +145,7 @@ namespace cjm::qt
             auto newButton = mainPanel_.buttons_.emplace_back(nullptr);
             if (!constructObj(logger_, newButton, std::tie(data)))
             {
-               logger_->error("Failed to create button.");
+               logger_->error("Failed to create button."_lt);
                return false;
             }
             newButton->setSizePolicy(Panel::btn_size_policy);
@@ -5,6 +5,7 @@
 namespace cjm::qt
 {
    using cjm::io::Log;
+   using namespace cjm::data::log_literals;
 
    InfoDisplay::InfoDisplay(QWidget* parent) : QWidget(parent) {}
 
@@ -18,7 +19,7 @@ namespace cjm::qt
 
       if (!constructObj(logger_, mainPanel_.layout))
       {
-         logger_->error("Failed to create the layout.");
+         logger_->error("Failed to create the layout."_lt);
          return false;
       }
 
@@ -36,13 +37,13 @@ namespace cjm::qt
 
       if (!initialised_)
       {
-         logger_->error("InfoDisplay not initialised.");
+         logger_->error("InfoDisplay not initialised."_lt);
          return;
       }
 
       if (row < 0)
       {
-         logger_->warn("Cannot use a negative row number.", Log::pack("used row", row));
+         CJM_LOG_WARN(logger_, "Cannot use a negative row number.", Log::pack("used row"_lt, row));
          return;
       }
 
@@ -56,9 +57,9 @@ namespace cjm::qt
                   constructObj(logger_, mainPanel_.infoLabels[i].second)))
             {
                logger_->error(
-                  "Failed to create the labels.",
-                  Log::pack("requested row", row),
-                  Log::pack("current number of rows", i));
+                  "Failed to create the labels."_lt,
+                  Log::pack("requested row"_lt, row),
+                  Log::pack("current number of rows"_lt, i));
                mainPanel_.infoLabels.resize(i);
                return;
             }
@@ -75,22 +76,23 @@ namespace cjm::qt
    {
       if (!initialised_)
       {
-         logger_->error("InfoDisplay not initialised.");
+         logger_->error("InfoDisplay not initialised."_lt);
          return;
       }
 
       if (row < 0)
       {
-         logger_->warn("Tried to access a negative row.", Log::pack("requested row", row));
+         CJM_LOG_WARN(logger_, "Tried to access a negative row.", Log::pack("requested row"_lt, row));
          return;
       }
 
       if (mainPanel_.infoLabels.size() <= static_cast<unsigned int>(row))
       {
-         logger_->warn(
+         CJM_LOG_WARN(
+            logger_,
             "Non-existent row.",
-            Log::pack("requested row", row),
-            Log::pack("number of rows", mainPanel_.infoLabels.size()));
+            Log::pack("requested row"_lt, row),
+            Log::pack("number of rows"_lt, mainPanel_.infoLabels.size()));
          return;
       }
 
@@ -0,0 +1,137 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "LogSiteList.hpp"
+
+#include "common/algorithm/utility.hpp"
+
+#include <QSignalBlocker>
+
+namespace cjm::qt
+{
+   using cjm::io::Log;
+   using cjm::io::LogSite;
+   using namespace cjm::data::log_literals;
+
+   LogSiteList::LogSiteList(QWidget* parent) : QWidget(parent) {}
+
+   bool LogSiteList::init()
+   {
+      using cjm::alg::constructObj;
+      using Panel = MainPanel;
+
+      logger_ = cjm::io::Log::logger();
+      if (logger_ == nullptr) return false;
+
+      if (!constructObj(logger_, mainPanel_.siteList))
+      {
+         logger_->error("Failed to create the site list."_lt);
+         return false;
+      }
+
+      const char* str{ Panel::refresh_label.data() };
+      if (!constructObj(logger_, mainPanel_.refreshButton, std::tie(str)))
+      {
+         logger_->error("Failed to create the refresh button."_lt);
+         return false;
+      }
+
+      if (!constructObj(logger_, mainPanel_.layout))
+      {
+         logger_->error("Failed to create the layout."_lt);
+         return false;
+      }
+
+      mainPanel_.layout->setContentsMargins(Panel::margin, Panel::margin, Panel::margin, Panel::margin);
+      mainPanel_.layout->setSpacing(Panel::spacing);
+      mainPanel_.layout->addWidget(mainPanel_.siteList);
+      mainPanel_.layout->addWidget(mainPanel_.refreshButton);
+      setLayout(mainPanel_.layout);
+
+      connect(mainPanel_.siteList, &QListWidget::itemChanged, this, &LogSiteList::toggleSite_);
+      connect(mainPanel_.refreshButton, &QPushButton::clicked, this, &LogSiteList::refresh);
+
+      initialised_ = true;
+      refresh();
+      return true;
+   }
+
+   void LogSiteList::refresh()
+   {
+      using cjm::alg::constructObj;
+      using LogMsg = cjm::data::LogMsg;
+
+      if (!initialised_)
+      {
+         logger_->error("LogSiteList not initialised."_lt);
+         return;
+      }
+
+      // Rebuilding the list must not toggle any site.
+      QSignalBlocker blocker{ mainPanel_.siteList };
+      mainPanel_.siteList->clear();
+
+      sites_ = LogSite::sites();
+      for (size_t i = 0U; i < sites_.size(); ++i)
+      {
+         const LogSite*   site{ sites_[i] };
+         std::string_view levelKey{ LogMsg::level_keys[static_cast<int>(site->level())] };
+
+         QString text{ QString("[%1] %2:%3 - %4")
+                          .arg(QString::fromUtf8(levelKey.data(), static_cast<int>(levelKey.size())))
+                          .arg(site->file())
+                          .arg(site->line())
+                          .arg(site->function()) };
+
+         QListWidgetItem* item{ nullptr };
+         if (!constructObj(logger_, item, std::tie(text, mainPanel_.siteList)))
+         {
+            logger_->error("Failed to create a site item."_lt, Log::pack("site index"_lt, i));
+            return;
+         }
+         item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+         item->setCheckState(site->enabled() ? Qt::Checked : Qt::Unchecked);
+         item->setData(Qt::UserRole, static_cast<qulonglong>(i));
+      }
+   }
+
+   void LogSiteList::toggleSite_(QListWidgetItem* item)
+   {
+      size_t index{ static_cast<size_t>(item->data(Qt::UserRole).toULongLong()) };
+      if (index >= sites_.size())
+      {
+         CJM_LOG_WARN(logger_, "Non-existent log site.", Log::pack("site index"_lt, index));
+         return;
+      }
+
+      bool enabled{ item->checkState() == Qt::Checked };
+      sites_[index]->setEnabled(enabled);
+      CJM_LOG_INFO(
+         logger_,
+         "Log site toggled.",
+         Log::pack("file"_lt, sites_[index]->file()),
+         Log::pack("line"_lt, sites_[index]->line()),
+         Log::pack("enabled"_lt, enabled));
+   }
+} // namespace cjm::qt
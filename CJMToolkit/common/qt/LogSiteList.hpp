@@ -0,0 +1,99 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_QT_LOGSITELIST_HPP
+#define COMMON_QT_LOGSITELIST_HPP
+
+#include "common/io/Log.hpp"
+#include "common/io/LogSite.hpp"
+
+#include <QLayout>
+#include <QListWidget>
+#include <QPushButton>
+#include <QWidget>
+#include <string_view>
+#include <vector>
+
+namespace cjm::qt
+{
+   /**
+    * @brief List of the registered logging sites, each with a check box that enables or disables it.
+    */
+   class LogSiteList : public QWidget
+   {
+      Q_OBJECT
+
+   public:
+      /**
+       * @brief Main panel of the widget.
+       */
+      struct MainPanel
+      {
+         /********** CONSTANTS **********/
+         static constexpr int margin{ 5 };  /**< Content margin. */
+         static constexpr int spacing{ 5 }; /**< Spacing between elements. */
+
+         static constexpr std::string_view refresh_label{ "REFRESH" }; /**< Label of the refresh button. */
+
+         /********** UI OBJECTS **********/
+         QVBoxLayout* layout{ nullptr };        /**< Layout of the panel. */
+         QListWidget* siteList{ nullptr };      /**< List of the logging sites. */
+         QPushButton* refreshButton{ nullptr }; /**< Button that reloads the list of sites. */
+      };
+
+      /**
+       * @brief Constructor.
+       * @param parent Parent of the current widget.
+       */
+      explicit LogSiteList(QWidget* parent = nullptr);
+
+      /**
+       * @brief Initialise the widget.
+       * @return true on success, false otherwise.
+       */
+      bool init();
+
+      /**
+       * @brief Reload the list of registered sites.
+       */
+      void refresh();
+
+   private:
+      /**
+       * @brief Enable or disable the site of an item, according to its check box.
+       * @param item Item that was changed.
+       */
+      void toggleSite_(QListWidgetItem* item);
+
+      bool initialised_{ false }; /**< true if the widget has been initialised. */
+
+      cjm::io::Log* logger_{ nullptr }; /**< Message logger. */
+
+      std::vector<cjm::io::LogSite*> sites_; /**< Sites shown in the list, in the same order. */
+
+      MainPanel mainPanel_; /**< Main panel. */
+   };
+} // namespace cjm::qt
+
+#endif // COMMON_QT_LOGSITELIST_HPP
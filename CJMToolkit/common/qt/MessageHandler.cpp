@@ -0,0 +1,107 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "MessageHandler.hpp"
+
+#include <QByteArray>
+
+namespace cjm::qt
+{
+   using cjm::io::Log;
+   using namespace cjm::data::log_literals;
+
+   /********** STATIC VARIABLES DEFINITIONS **********/
+   QtMessageHandler MessageHandler::previous_{ nullptr };
+
+   /********** METHOD DEFINITIONS **********/
+   void MessageHandler::install()
+   {
+      QtMessageHandler previous{ qInstallMessageHandler(&MessageHandler::handle_) };
+      if (previous != &MessageHandler::handle_) previous_ = previous;
+   }
+
+   MessageHandler::LogMsg::Level MessageHandler::level(QtMsgType type)
+   {
+      switch (type)
+      {
+      case QtDebugMsg:
+         return LogMsg::Level::trace;
+      case QtInfoMsg:
+         return LogMsg::Level::info;
+      case QtWarningMsg:
+         return LogMsg::Level::warn;
+      case QtCriticalMsg:
+         return LogMsg::Level::error;
+      case QtFatalMsg:
+         return LogMsg::Level::fatal;
+      }
+      return LogMsg::Level::warn;
+   }
+
+   void MessageHandler::uninstall()
+   {
+      qInstallMessageHandler(previous_);
+      previous_ = nullptr;
+   }
+
+   void MessageHandler::handle_(QtMsgType type, const QMessageLogContext& context, const QString& message)
+   {
+      Log* logger{ Log::logger() };
+      if (logger == nullptr)
+      {
+         if (previous_ != nullptr) previous_(type, context, message);
+         return;
+      }
+
+      // Qt only fills the source location when QT_MESSAGELOGCONTEXT is defined or in debug builds.
+      QByteArray       text{ message.toUtf8() };
+      std::string_view category{ context.category != nullptr ? context.category : "default" };
+
+      // Critical and fatal messages must not be dropped: a fatal one is written before Qt aborts the process.
+      auto record = [logger, type, &text](const auto&... data) {
+         std::string_view msg(text.constData(), static_cast<size_t>(text.size()));
+         if (type == QtCriticalMsg || type == QtFatalMsg)
+         {
+            logger->log(level(type), msg, data...);
+         }
+         else
+         {
+            logger->post(level(type), msg, data...);
+         }
+      };
+
+      if (context.file != nullptr)
+      {
+         record(
+            Log::pack(Log::category_name, category),
+            Log::pack("file"_lt, std::string_view(context.file)),
+            Log::pack("line"_lt, context.line),
+            Log::pack("function"_lt, std::string_view(context.function != nullptr ? context.function : "")));
+      }
+      else
+      {
+         record(Log::pack(Log::category_name, category));
+      }
+   }
+} // namespace cjm::qt
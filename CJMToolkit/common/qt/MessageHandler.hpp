@@ -0,0 +1,79 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#ifndef COMMON_QT_MESSAGEHANDLER_HPP
+#define COMMON_QT_MESSAGEHANDLER_HPP
+
+#include "common/io/Log.hpp"
+
+#include <QString>
+#include <QtGlobal>
+
+namespace cjm::qt
+{
+   /**
+    * @brief Handler that routes the diagnostics of Qt itself, like widget or stylesheet warnings, to the logger.
+    * @details Debug, info and warning messages are recorded with Log::post, so the thread that raised them never waits
+    *          for the writer or for the console. Critical and fatal messages are recorded with Log::log, so they are
+    *          never dropped and a fatal one is written before Qt aborts the process. Their retention rings, filters and
+    *          sinks are the ones of every other message. The Qt category is added as the category datagram, followed by
+    *          the file, line and function of the context when Qt provides them. Without a logger, messages go to the
+    *          previous handler.
+    */
+   class MessageHandler
+   {
+   public:
+      using LogMsg = cjm::io::Log::LogMsg;
+
+      /**
+       * @brief Install the handler, keeping the previous one.
+       */
+      static void install();
+
+      /**
+       * @brief Convert the type of a Qt message into a logging level.
+       * @param type Type of the Qt message.
+       * @return Logging level: debug messages are traces, critical messages are errors.
+       */
+      static LogMsg::Level level(QtMsgType type);
+
+      /**
+       * @brief Restore the handler that was installed before install() was called.
+       */
+      static void uninstall();
+
+   private:
+      /**
+       * @brief Record a Qt message.
+       * @param type Type of the message.
+       * @param context Category and source location of the message.
+       * @param message Text of the message.
+       */
+      static void handle_(QtMsgType type, const QMessageLogContext& context, const QString& message);
+
+      static QtMessageHandler previous_; /**< Handler installed before this one. */
+   };
+} // namespace cjm::qt
+
+#endif // COMMON_QT_MESSAGEHANDLER_HPP
@@ -27,13 +27,14 @@
 namespace cjm::qt
 {
    using cjm::io::Log;
+   using namespace cjm::data::log_literals;
 
    Settings::Settings(std::string_view fileName, Format fileFormat) : format_{ fileFormat }, fileName_{ fileName }
    {
       file_.setFileName(fileName_.data());
       if (!file_.open(open_mode))
       {
-         logger_->error("Failed to open the settings file.", Log::pack("file name", fileName_));
+         logger_->error("Failed to open the settings file."_lt, Log::pack("file name"_lt, fileName_));
          status_ = Status::file_error;
       }
       else
@@ -64,9 +65,9 @@ namespace cjm::qt
       if (reader.hasError())
       {
          logger_->error(
-            "Error while reading the xml settings file.",
-            Log::pack("file name", fileName_),
-            Log::pack("error message", reader.errorString().toUtf8().constData()));
+            "Error while reading the xml settings file."_lt,
+            Log::pack("file name"_lt, fileName_),
+            Log::pack("error message"_lt, reader.errorString().toUtf8().constData()));
          status_ = Status::file_error;
          return;
       }
@@ -82,9 +83,9 @@ namespace cjm::qt
          {
          case QXmlStreamReader::TokenType::Invalid:
             logger_->error(
-               "Invalid token in the xml settings file.",
-               Log::pack("file name", fileName_),
-               Log::pack("error message", reader.errorString().toUtf8().constData()));
+               "Invalid token in the xml settings file."_lt,
+               Log::pack("file name"_lt, fileName_),
+               Log::pack("error message"_lt, reader.errorString().toUtf8().constData()));
             status_ = Status::format_error;
             break;
          case QXmlStreamReader::TokenType::NoToken:
@@ -114,9 +115,9 @@ namespace cjm::qt
       if (reader.hasError())
       {
          logger_->error(
-            "Error while reading the xml settings file.",
-            Log::pack("file name", fileName_),
-            Log::pack("error message", reader.errorString().toUtf8().constData()));
+            "Error while reading the xml settings file."_lt,
+            Log::pack("file name"_lt, fileName_),
+            Log::pack("error message"_lt, reader.errorString().toUtf8().constData()));
          status_ = Status::format_error;
       }
    }
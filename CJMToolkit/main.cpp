@@ -24,6 +24,7 @@
 
 #include "MainWindow.hpp"
 #include "common/io/Log.hpp"
+#include "common/qt/MessageHandler.hpp"
 #include "common/qt/Settings.hpp"
 
 #include <QApplication>
@@ -40,9 +41,11 @@ int main(int argc, char* argv[])
 {
    using cjm::data::BaseSettings;
    using cjm::io::Log;
+   using cjm::qt::MessageHandler;
    using cjm::qt::Settings;
+   using namespace cjm::data::log_literals;
 
-   if (!Log::init(log_file))
+   if (!Log::init(log_file, Log::Mode::async))
    {
       std::cout << "Failed to initialise logger.\n";
       return -1;
@@ -50,43 +53,59 @@ int main(int argc, char* argv[])
    Log* logger{ Log::logger() };
    logger->setLevel(Log::LogMsg::Level::trace);
 
+   // Diagnostics of Qt itself, including those raised while constructing the application, go to the logger.
+   MessageHandler::install();
+
    QApplication a(argc, argv);
 
    Settings settings{ settings_file.data(), Settings::Format::xml };
    if (settings.status() != Settings::Status::no_error)
    {
-      logger->fatal("Failed to initialise the settings file.");
+      logger->fatal("Failed to initialise the settings file."_lt);
       return -1;
    }
-   logger->info("Settings file loaded successfully.", Log::pack("settings file", settings_file));
+   CJM_LOG_INFO(logger, "Settings file loaded successfully.", Log::pack("settings file"_lt, settings_file));
 
    BaseSettings settingsRoot{ settings.enterNode(settings_root) };
    if (!settingsRoot.valid())
    {
       logger->error(
-         "No root settings node.",
-         Log::pack("settings file", settings_file),
-         Log::pack("required root", settings_root));
+         "No root settings node."_lt,
+         Log::pack("settings file"_lt, settings_file),
+         Log::pack("required root"_lt, settings_root));
       return -1;
    }
 
+   BaseSettings logSettings{ settingsRoot.enterNode(Log::Keys::node) };
+   if (logSettings.valid())
+   {
+      if (!logger->configure(logSettings))
+      {
+         CJM_LOG_WARN(logger, "Keeping the default logging sinks.", Log::pack("settings file"_lt, settings_file));
+      }
+   }
+
    BaseSettings mainWindowSettings{ settingsRoot.enterNode(settings_main_window) };
    if (!mainWindowSettings.valid())
    {
-      logger->warn(
+      CJM_LOG_WARN(
+         logger,
          "No settings for the main window.",
-         Log::pack("settings file", settings_file),
-         Log::pack("missing node", settings_main_window));
+         Log::pack("settings file"_lt, settings_file),
+         Log::pack("missing node"_lt, settings_main_window));
    }
 
    MainWindow w{ mainWindowSettings };
    if (!w.init())
    {
-      logger->fatal("Failed to initialise the main window.");
+      logger->fatal("Failed to initialise the main window."_lt);
       return -1;
    }
 
    w.show();
 
-   return a.exec();
+   int result{ a.exec() };
+   MessageHandler::uninstall();
+   Log::shutdown();
+   return result;
 }
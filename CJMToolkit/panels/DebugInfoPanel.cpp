@@ -4,6 +4,8 @@
 #include "common/version_info.hpp"
 #include "version_info.hpp"
 
+using namespace cjm::data::log_literals;
+
 DebugInfoPanel::DebugInfoPanel(QWidget* parent) : QWidget(parent) {}
 
 bool DebugInfoPanel::init()
@@ -13,7 +15,7 @@ bool DebugInfoPanel::init()
 
    if (!initUI_())
    {
-      logger_->error("Failed to initialise the UI.");
+      logger_->error("Failed to initialise the UI."_lt);
       return false;
    }
 
@@ -29,7 +31,7 @@ bool DebugInfoPanel::initLeftPanel_()
 
    if (!makeObj(logger_, panel.infoDisplay))
    {
-      logger_->error("Failed to create the information display panel.");
+      logger_->error("Failed to create the information display panel."_lt);
       return false;
    }
 
@@ -40,7 +42,7 @@ bool DebugInfoPanel::initLeftPanel_()
 
    if (!constructObj(logger_, panel.infoLayout))
    {
-      logger_->error("Failed to create the information panel layout.");
+      logger_->error("Failed to create the information panel layout."_lt);
       return false;
    }
    panel.infoLayout->setContentsMargins(Panel::margin, Panel::margin, Panel::margin, Panel::margin);
@@ -50,7 +52,7 @@ bool DebugInfoPanel::initLeftPanel_()
    const char* str{ Panel::info_display_title.data() };
    if (!constructObj(logger_, panel.infoBox, std::tie(str)))
    {
-      logger_->error("Failed to create the information panel box.");
+      logger_->error("Failed to create the information panel box."_lt);
       return false;
    }
    panel.infoBox->setContentsMargins(0, 0, 0, 0);
@@ -58,7 +60,7 @@ bool DebugInfoPanel::initLeftPanel_()
 
    if (!constructObj(logger_, panel.layout))
    {
-      logger_->error("Failed to create the layout.");
+      logger_->error("Failed to create the layout."_lt);
       return false;
    }
 
@@ -72,6 +74,45 @@ bool DebugInfoPanel::initLeftPanel_()
 
 bool DebugInfoPanel::initRightPanel_()
 {
+   using cjm::alg::constructObj;
+   using cjm::alg::makeObj;
+   using Panel = RightPanel;
+   RightPanel& panel{ mainPanel_.rightPanel };
+
+   if (!makeObj(logger_, panel.logSiteList))
+   {
+      logger_->error("Failed to create the log site list."_lt);
+      return false;
+   }
+
+   if (!constructObj(logger_, panel.logSitesLayout))
+   {
+      logger_->error("Failed to create the log sites panel layout."_lt);
+      return false;
+   }
+   panel.logSitesLayout->setContentsMargins(Panel::margin, Panel::margin, Panel::margin, Panel::margin);
+   panel.logSitesLayout->setSpacing(Panel::spacing);
+   panel.logSitesLayout->addWidget(panel.logSiteList);
+
+   const char* str{ Panel::log_sites_title.data() };
+   if (!constructObj(logger_, panel.logSitesBox, std::tie(str)))
+   {
+      logger_->error("Failed to create the log sites panel box."_lt);
+      return false;
+   }
+   panel.logSitesBox->setContentsMargins(0, 0, 0, 0);
+   panel.logSitesBox->setLayout(panel.logSitesLayout);
+
+   if (!constructObj(logger_, panel.layout))
+   {
+      logger_->error("Failed to create the layout."_lt);
+      return false;
+   }
+
+   panel.layout->setContentsMargins(Panel::margin, Panel::margin, Panel::margin, Panel::margin);
+   panel.layout->setSpacing(Panel::spacing);
+   panel.layout->addWidget(panel.logSitesBox);
+
    return true;
 }
 
@@ -82,19 +123,19 @@ bool DebugInfoPanel::initUI_()
 
    if (!initLeftPanel_())
    {
-      logger_->error("Failed to initialise the left panel.");
+      logger_->error("Failed to initialise the left panel."_lt);
       return false;
    }
 
    if (!initRightPanel_())
    {
-      logger_->error("Failed to initialise the right panel.");
+      logger_->error("Failed to initialise the right panel."_lt);
       return false;
    }
 
    if (!constructObj(logger_, mainPanel_.layout))
    {
-      logger_->error("Failed to create the main layout.");
+      logger_->error("Failed to create the main layout."_lt);
       return false;
    }
 
@@ -103,6 +144,8 @@ bool DebugInfoPanel::initUI_()
 
    mainPanel_.layout->insertLayout(
       static_cast<int>(Panel::Order::left), mainPanel_.leftPanel.layout, Panel::left_stretch);
+   mainPanel_.layout->insertLayout(
+      static_cast<int>(Panel::Order::right), mainPanel_.rightPanel.layout, Panel::right_stretch);
 
    setLayout(mainPanel_.layout);
 
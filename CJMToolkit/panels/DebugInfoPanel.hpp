@@ -3,6 +3,7 @@
 
 #include "common/io/Log.hpp"
 #include "common/qt/InfoDisplay.hpp"
+#include "common/qt/LogSiteList.hpp"
 #include "common/version_info.hpp"
 #include "version_info.hpp"
 
@@ -54,6 +55,24 @@ public:
       cjm::qt::InfoDisplay* infoDisplay{ nullptr }; /**< Display for general program information. */
    };
 
+   /**
+    * @brief Right panel of the widget.
+    */
+   struct RightPanel
+   {
+      /********** CONSTANTS **********/
+      static constexpr int margin{ 5 };  /**< Content margin. */
+      static constexpr int spacing{ 5 }; /**< Spacing between elements. */
+
+      static constexpr std::string_view log_sites_title{ "LOG SITES" }; /**< Title of the log sites box. */
+
+      /********** UI OBJECTS **********/
+      QVBoxLayout*          layout{ nullptr };         /**< Layout of the panel. */
+      QGroupBox*            logSitesBox{ nullptr };    /**< Log sites group box. */
+      QVBoxLayout*          logSitesLayout{ nullptr }; /**< Layout for the log sites group box. */
+      cjm::qt::LogSiteList* logSiteList{ nullptr };    /**< List of the logging sites that can be toggled. */
+   };
+
    /**
     * @brief Main panel of the widget.
     */
@@ -77,6 +96,7 @@ public:
       /********** UI OBJECTS **********/
       QHBoxLayout* layout{ nullptr }; /**< Main layout of the panel. */
       LeftPanel    leftPanel;         /**< Left panel of the widget. */
+      RightPanel   rightPanel;        /**< Right panel of the widget. */
    };
 
    /**
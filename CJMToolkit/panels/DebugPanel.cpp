@@ -26,6 +26,8 @@
 
 #include "common/algorithm/utility.hpp"
 
+using namespace cjm::data::log_literals;
+
 DebugPanel::DebugPanel(QWidget* parent) : QWidget(parent) {}
 
 bool DebugPanel::init()
@@ -48,13 +50,13 @@ bool DebugPanel::initPages_()
 
    if (!makeObj(logger_, panel.infoPage))
    {
-      logger_->error("Failed ot create the DEBUG::INFO page.");
+      logger_->error("Failed ot create the DEBUG::INFO page."_lt);
       return false;
    }
 
    if (!constructObj(logger_, panel.layout))
    {
-      logger_->error("Failed to create the page layout.");
+      logger_->error("Failed to create the page layout."_lt);
       return false;
    }
 
@@ -71,7 +73,7 @@ bool DebugPanel::initPageSelector_(PageSelectorPanel& panel)
 
    if (!makeObj(logger_, panel.pageSelector, std::tuple<>(), std::tie(Panel::buttons)))
    {
-      logger_->error("Failed to create the page selector.");
+      logger_->error("Failed to create the page selector."_lt);
       return false;
    }
 
@@ -85,19 +87,19 @@ bool DebugPanel::initUI_()
 
    if (!initPageSelector_(mainPanel_.pageSelectorPanel))
    {
-      logger_->error("Failed to initialise the page selector.");
+      logger_->error("Failed to initialise the page selector."_lt);
       return false;
    }
 
    if (!initPages_())
    {
-      logger_->error("Failed to initialise the pages.");
+      logger_->error("Failed to initialise the pages."_lt);
       return false;
    }
 
    if (!constructObj(logger_, mainPanel_.layout))
    {
-      logger_->error("Failed to create the main layout.");
+      logger_->error("Failed to create the main layout."_lt);
       return false;
    }
 
@@ -0,0 +1,21 @@
+TEMPLATE = app
+TARGET = cjm-fmtbench
+
+QT -= core gui
+CONFIG += console c++17 release
+CONFIG -= app_bundle qt debug
+
+INCLUDEPATH += ../..
+
+LIBS += -lz
+
+SOURCES += \
+    ../../common/data/BinaryLog.cpp \
+    ../../common/data/LogMsg.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../common/data/BinaryLog.hpp \
+    ../../common/data/LogMsg.hpp \
+    ../../common/data/LogText.hpp \
+    ../../common/format/Format.hpp
@@ -0,0 +1,120 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+
+#include "common/data/LogMsg.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+constexpr std::string_view usage{ "Usage: cjm-fmtbench [iterations]" };
+
+/**
+ * @brief Number of messages built by each path when no count is given.
+ */
+constexpr long long default_iterations{ 1000000 };
+
+namespace
+{
+   using cjm::data::LogMsg;
+
+   /**
+    * @brief Add a datagram the way LogMsg did before cjm::fmt, through two string streams.
+    * @param message Message to add the datagram to.
+    * @param data Description and value of the datagram.
+    */
+   template<typename DescriptionType, typename DataType>
+   void addStreamed(LogMsg& message, const std::pair<DescriptionType, DataType>& data)
+   {
+      std::stringstream descriptionStream;
+      descriptionStream << data.first;
+      std::stringstream dataStream;
+      dataStream << data.second;
+
+      message.addData(descriptionStream.str(), dataStream.str());
+   }
+
+   /**
+    * @brief Build the same message repeatedly and measure the average time per message.
+    * @param iterations Number of messages to build.
+    * @param add Callable adding the datagrams to a message, invoked with the message and the iteration.
+    * @param checksum Incremented by the size of the data of each message, so that the work cannot be optimised away.
+    * @return Average time per message, in nanoseconds.
+    */
+   template<typename Add>
+   double measure(long long iterations, Add add, size_t& checksum)
+   {
+      LogMsg message;
+      auto   start{ std::chrono::steady_clock::now() };
+      for (long long i = 0; i < iterations; ++i)
+      {
+         message.reset(LogMsg::Level::info, i, "benchmark message");
+         add(message, i);
+         message.forEachData([&checksum](std::string_view, std::string_view data) { checksum += data.size(); });
+      }
+      std::chrono::duration<double, std::nano> elapsed{ std::chrono::steady_clock::now() - start };
+      return elapsed.count() / static_cast<double>(iterations);
+   }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+   long long iterations{ default_iterations };
+   if (argc > 2 || (argc == 2 && (iterations = std::atoll(argv[1])) <= 0))
+   {
+      std::cerr << usage << '\n';
+      return -1;
+   }
+
+   // Each message carries the datagrams of a typical call: an integer, a floating point value and a string.
+   const std::string name{ "settings.xml" };
+   size_t            checksum{ 0U };
+   double            streamed{ measure(
+      iterations,
+      [&name](LogMsg& message, long long i) {
+         addStreamed(message, std::pair<std::string_view, long long>("count", i));
+         addStreamed(message, std::pair<std::string_view, double>("ratio", static_cast<double>(i) / 7.0));
+         addStreamed(message, std::pair<std::string_view, const std::string&>("file", name));
+      },
+      checksum) };
+   double formatted{ measure(
+      iterations,
+      [&name](LogMsg& message, long long i) {
+         message.addData(std::pair<std::string_view, long long>("count", i));
+         message.addData(std::pair<std::string_view, double>("ratio", static_cast<double>(i) / 7.0));
+         message.addData(std::pair<std::string_view, const std::string&>("file", name));
+      },
+      checksum) };
+
+   std::cout << "iterations:   " << iterations << '\n';
+   std::cout << "stringstream: " << streamed << " ns/message\n";
+   std::cout << "cjm::fmt:     " << formatted << " ns/message\n";
+   std::cout << "speed-up:     " << streamed / formatted << "x\n";
+   std::cout << "checksum:     " << checksum << '\n';
+   return 0;
+}
@@ -0,0 +1,28 @@
+TEMPLATE = app
+TARGET = cjm-logdecode
+
+QT -= core gui
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += ../..
+
+LIBS += -lz
+
+SOURCES += \
+    ../../common/data/BinaryLog.cpp \
+    ../../common/data/LogArchive.cpp \
+    ../../common/data/LogMsg.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../common/data/BinaryLog.hpp \
+    ../../common/data/LogArchive.hpp \
+    ../../common/data/LogMsg.hpp \
+    ../../common/data/LogText.hpp \
+    ../../common/format/Format.hpp
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,253 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "common/data/BinaryLog.hpp"
+#include "common/data/LogArchive.hpp"
+#include "common/data/LogMsg.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+constexpr std::string_view usage{ "Usage: cjm-logdecode <log file> [--data] [--from <timestamp [ms]>]" };
+constexpr std::string_view data_option{ "--data" };
+constexpr std::string_view from_option{ "--from" };
+constexpr std::string_view tab{ "   " };
+
+namespace
+{
+   using cjm::data::LogArchive;
+
+   /**
+    * @brief Stream buffer that decompresses the blocks of a cjm::data::LogArchive one at a time.
+    */
+   class ArchiveBuffer : public std::streambuf
+   {
+   public:
+      /**
+       * @brief Constructor.
+       * @param archive Archive stream.
+       * @param index Index of the archive.
+       * @param firstBlock Block to start reading from.
+       */
+      ArchiveBuffer(std::istream& archive, const std::vector<LogArchive::Block>& index, size_t firstBlock) :
+         archive_{ archive }, index_{ index }, nextBlock_{ firstBlock }
+      {
+      }
+
+      /**
+       * @brief Check whether a damaged block stopped the reading.
+       * @return true or false.
+       */
+      bool damaged() const
+      {
+         return damaged_;
+      }
+
+   protected:
+      /**
+       * @brief Decompress the next block when the current one is exhausted.
+       * @return Next character, or EOF at the end of the archive.
+       */
+      int_type underflow() override
+      {
+         while (gptr() == egptr())
+         {
+            if (damaged_ || nextBlock_ >= index_.size()) return traits_type::eof();
+            if (!LogArchive::readBlock(archive_, index_[nextBlock_], block_))
+            {
+               damaged_ = true;
+               return traits_type::eof();
+            }
+            ++nextBlock_;
+            setg(block_.data(), block_.data(), block_.data() + block_.size());
+         }
+
+         return traits_type::to_int_type(*gptr());
+      }
+
+   private:
+      std::istream&                         archive_;          /**< Archive stream. */
+      const std::vector<LogArchive::Block>& index_;            /**< Index of the archive. */
+      size_t                                nextBlock_{ 0U };  /**< Next block to decompress. */
+      std::string                           block_;            /**< Current uncompressed block. */
+      bool                                  damaged_{ false }; /**< If true, a block could not be decompressed. */
+   };
+} // namespace
+
+int main(int argc, char* argv[])
+{
+   using cjm::data::BinaryLog;
+   using cjm::data::LogMsg;
+
+   if (argc < 2)
+   {
+      std::cerr << usage << '\n';
+      return -1;
+   }
+
+   // Timestamps are compared in [ns], the first version of the binary format stored them in [ms].
+   constexpr long long ns_per_ms{ 1000000 };
+   constexpr long long limit{ std::numeric_limits<long long>::max() / ns_per_ms };
+   bool                printData{ false };
+   long long           from{ std::numeric_limits<long long>::min() };
+   for (int i = 2; i < argc; ++i)
+   {
+      if (argv[i] == data_option)
+      {
+         printData = true;
+      }
+      else if (argv[i] == from_option && i + 1 < argc)
+      {
+         from = std::clamp(std::atoll(argv[++i]), -limit, limit) * ns_per_ms;
+      }
+      else
+      {
+         std::cerr << usage << '\n';
+         return -1;
+      }
+   }
+
+   std::ifstream file{ argv[1], std::ios::in | std::ios::binary };
+   if (file.fail())
+   {
+      std::cerr << "Failed to open the log file.\n";
+      return -1;
+   }
+
+   // Rotated files may be compressed: decompress them starting from the block that contains the requested time.
+   std::vector<LogArchive::Block> index;
+   bool                           archive{ LogArchive::isArchive(file) };
+   size_t                         firstBlock{ 0U };
+   std::string                    signature(BinaryLog::magic.size(), '\0');
+   auto                           binary = [&signature]() {
+      return signature == BinaryLog::magic || signature == BinaryLog::interned_magic ||
+             signature == BinaryLog::legacy_magic;
+   };
+   if (archive)
+   {
+      std::string firstData;
+      if (!LogArchive::readIndex(file, index) || (!index.empty() && !LogArchive::readBlock(file, index[0], firstData)))
+      {
+         std::cerr << "Damaged log archive.\n";
+         return -1;
+      }
+      signature = firstData.substr(0U, signature.size());
+      firstBlock = LogArchive::findBlock(index, from);
+   }
+
+   ArchiveBuffer archiveBuffer{ file, index, firstBlock };
+   std::istream  input{ archive ? static_cast<std::streambuf*>(&archiveBuffer) : file.rdbuf() };
+
+   if (archive && !binary())
+   {
+      std::cout << input.rdbuf();
+      if (archiveBuffer.damaged())
+      {
+         std::cerr << "Damaged block in the log archive.\n";
+         return -1;
+      }
+      return 0;
+   }
+
+   // Blocks after the first one do not repeat the signature.
+   if (firstBlock == 0U)
+   {
+      if (!input.read(signature.data(), static_cast<std::streamsize>(signature.size())) || !binary())
+      {
+         std::cerr << "Not a binary log file.\n";
+         return -1;
+      }
+   }
+   long long scale{ signature == BinaryLog::legacy_magic ? ns_per_ms : 1 };
+
+   // Texts defined in the file, indexed by id.
+   std::vector<std::string> formats;
+   auto                     lookup = [&formats](std::uint32_t id) {
+      return id < formats.size() ? std::string_view(formats[id]) : std::string_view();
+   };
+
+   // A record cut short by the end of the file is malformed too, only the end of a record is a valid end of file.
+   BinaryLog::Record record;
+   while (input.peek() != std::istream::traits_type::eof())
+   {
+      if (!BinaryLog::readRecord(input, record, signature))
+      {
+         std::cerr << "Malformed record in the log file.\n";
+         return -1;
+      }
+
+      if (record.type == BinaryLog::RecordType::format)
+      {
+         // Texts are defined in order of id, from the beginning of the file or of each archive block.
+         if (record.id > formats.size())
+         {
+            std::cerr << "Invalid text id.\n";
+            return -1;
+         }
+         if (record.id == formats.size()) formats.emplace_back();
+         formats[record.id] = std::move(record.text);
+         continue;
+      }
+
+      if (record.level >= LogMsg::level_keys.size())
+      {
+         std::cerr << "Invalid message level.\n";
+         return -1;
+      }
+      if (record.id != BinaryLog::no_id && record.id >= formats.size())
+      {
+         std::cerr << "Invalid text id.\n";
+         return -1;
+      }
+      long long timestamp{ record.timestamp * scale };
+      if (timestamp < from) continue;
+
+      std::string_view text{ record.id == BinaryLog::no_id ? std::string_view(record.text) : lookup(record.id) };
+      LogMsg           message{ static_cast<LogMsg::Level>(record.level), timestamp, text };
+      std::cout << message.baseMessage() << '\n';
+
+      if (printData)
+      {
+         for (const auto& [description, value] : BinaryLog::decodeData(record.payload, lookup))
+         {
+            std::cout << tab << description << ": " << value << '\n';
+         }
+      }
+   }
+
+   if (archiveBuffer.damaged())
+   {
+      std::cerr << "Damaged block in the log archive.\n";
+      return -1;
+   }
+
+   return 0;
+}
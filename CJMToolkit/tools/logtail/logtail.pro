@@ -0,0 +1,23 @@
+TEMPLATE = app
+TARGET = cjm-logtail
+
+QT -= core gui
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += ../..
+
+# shm_open lives in librt on older glibc versions.
+LIBS += -lrt
+
+SOURCES += \
+    ../../common/io/ShmRing.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../common/io/ShmRing.hpp
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
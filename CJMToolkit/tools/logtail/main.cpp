@@ -0,0 +1,174 @@
+/*
+   MIT License
+
+   Copyright (c) [2021] [Davide Dravindran Pistilli] [https://github.com/DavidePistilli173/CJMToolkit]
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "common/io/ShmRing.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+constexpr std::string_view usage{ "Usage: cjm-logtail <shared-memory name> [--follow]" };
+constexpr std::string_view follow_option{ "--follow" };
+
+/**
+ * @brief Text replacing the beginning of a message whose first records were lost.
+ */
+constexpr std::string_view lost_marker{ "..." };
+
+/**
+ * @brief Text following a message that was cut.
+ */
+constexpr std::string_view truncated_marker{ " [truncated]" };
+
+/**
+ * @brief Time between two checks for new records while following the log.
+ */
+constexpr std::chrono::milliseconds poll_interval{ 10 };
+
+/**
+ * @brief Attempts to read a record that is being written before giving it up.
+ */
+constexpr int busy_retries{ 1000 };
+
+/**
+ * @brief Time between two attempts to read a record that is being written.
+ */
+constexpr std::chrono::microseconds busy_backoff{ 50 };
+
+namespace
+{
+   /**
+    * @brief Check whether a process is still running.
+    * @param pid Process id.
+    * @return true or false.
+    */
+   bool running(long pid)
+   {
+      return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+   }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+   using cjm::io::ShmRing;
+
+   if (argc < 2)
+   {
+      std::cerr << usage << '\n';
+      return -1;
+   }
+
+   bool follow{ false };
+   for (int i = 2; i < argc; ++i)
+   {
+      if (argv[i] == follow_option)
+      {
+         follow = true;
+      }
+      else
+      {
+         std::cerr << usage << '\n';
+         return -1;
+      }
+   }
+
+   ShmRing ring;
+   if (!ring.attach(argv[1]))
+   {
+      std::cerr << "Failed to attach to the shared-memory ring.\n";
+      return -1;
+   }
+
+   // Start from the oldest record still in the ring.
+   std::uint64_t head{ ring.head() };
+   std::uint64_t next{ head > ring.slots() ? head - ring.slots() : 0U };
+   std::string   text;
+   std::string   message;
+   bool          joining{ false };
+   std::uint32_t flags{ 0U };
+   int           retries{ 0 };
+   while (true)
+   {
+      switch (ring.read(next, text, flags))
+      {
+      case ShmRing::Status::ok:
+         // A message longer than a slot spans several records, whose first ones may have been lost.
+         if ((flags & ShmRing::continuation) == 0U)
+         {
+            message.clear();
+         }
+         else if (!joining)
+         {
+            message.assign(lost_marker);
+         }
+         message += text;
+         joining = (flags & ShmRing::continues) != 0U;
+         if (!joining)
+         {
+            std::cout << message;
+            if ((flags & ShmRing::truncated) != 0U) std::cout << truncated_marker;
+            std::cout << '\n';
+         }
+         ++next;
+         retries = 0;
+         break;
+      case ShmRing::Status::busy:
+         // The writer may have died in the middle of the record.
+         if (++retries < busy_retries)
+         {
+            std::this_thread::sleep_for(busy_backoff);
+            break;
+         }
+         [[fallthrough]];
+      case ShmRing::Status::overwritten:
+      {
+         // The writer lapped the reader: skip to the oldest record still available.
+         head = ring.head();
+         std::uint64_t oldest{ head > ring.slots() ? head - ring.slots() : 0U };
+         std::uint64_t resume{ oldest > next ? oldest : next + 1U };
+         std::cout.flush();
+         std::cerr << "*** " << resume - next << " records lost ***\n";
+         next = resume;
+         joining = false;
+         retries = 0;
+         break;
+      }
+      case ShmRing::Status::not_written:
+         if (follow && (running(ring.writer()) || next < ring.head()))
+         {
+            std::cout.flush();
+            std::this_thread::sleep_for(poll_interval);
+            break;
+         }
+
+         // The writer will not finish the message being joined.
+         if (joining) std::cout << message << truncated_marker << '\n';
+         return 0;
+      }
+   }
+}